@@ -1,8 +1,9 @@
 
-    if(fCout){cout<<"#######################!!!!!!!!!!!!!!!All declarations for EEC successful!!!!!!!!!!!!!####################"<<endl;}
+    E3C_LOG_SETUP("#######################!!!!!!!!!!!!!!!All declarations for EEC successful!!!!!!!!!!!!!####################");
     
     // /////////////////////////////////////////////////
-    if(fCout) cout<<"subtraction histograms for E3C"<<endl;
+    //the truth, c-factor and unmatched copies of the E3C families are in the bank below (SetE3CFamilies)
+    E3C_LOG_SETUP("subtraction histograms for E3C");
 //     /////FOR E3C MIN BIAS SUBTRCTION////////
      h_MJ_e3c = new TH3D("h_MJ_e3c", "h_MJ_e3c", 22, new_bins_const,22, new_bins_const,100, new_bins);
      fOutput->Add(h_MJ_e3c);
@@ -14,533 +15,168 @@
      fOutput->Add(h_MJ2_e3c);
      h_MJ3_e3c = new TH3D("h_MJ3_e3c", "h_MJ3_e3c", 22, new_bins_const,22, new_bins_const,100, new_bins);
      fOutput->Add(h_MJ3_e3c);
-     h_MJ_e3c_tru = new TH3D("h_MJ_e3c_tru", "h_MJ_e3c_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MJ_e3c_tru);
-     h_MJ0_e3c_tru = new TH3D("h_MJ0_e3c_tru", "h_MJ0_e3c_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MJ0_e3c_tru);
-     h_MJ1_e3c_tru = new TH3D("h_MJ1_e3c_tru", "h_MJ1_e3c_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MJ1_e3c_tru);
-     h_MJ2_e3c_tru = new TH3D("h_MJ2_e3c_tru", "h_MJ2_e3c_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MJ2_e3c_tru);
-     h_MJ3_e3c_tru = new TH3D("h_MJ3_e3c_tru", "h_MJ3_e3c_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MJ3_e3c_tru);
+    E3C_LOG_SETUP("subtraction histograms for E3C 1");
 
-    if(fCout) cout<<"subtraction histograms for E3C 1"<<endl; 
-
-     h_MB1MB1MB1 = new TH3D("h_MB1MB1MB1", "h_MB1MB1MB1",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB1MB1);
      h_MB1MB1MB1_dat = new TH2D("h_MB1MB1MB1_dat", "h_MB1MB1MB1_dat",22, new_bins_const,100, new_bins);
      fOutput->Add(h_MB1MB1MB1_dat);
-     h_MB1MB1MB1_tru = new TH3D("h_MB1MB1MB1_tru", "h_MB1MB1MB1_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB1MB1_tru);
 
-    if(fCout) cout<<"subtraction histograms for E3C 2"<<endl; 
+    E3C_LOG_SETUP("subtraction histograms for E3C 2");
 
-     h_JJMB = new TH3D("h_JJMB", "h_JJMB", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_JJMB);
      h_JJMB_dat = new TH2D("h_JJMB_dat", "h_JJMB_dat", 22, new_bins_const,100, new_bins);
      fOutput->Add(h_JJMB_dat);
-     h_JJMB_tru = new TH3D("h_JJMB_tru", "h_JJMB_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_JJMB_tru);
-     h_JMBMB = new TH3D("h_JMBMB", "h_JMBMB",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_JMBMB);
      h_JMBMB_dat = new TH2D("h_JMBMB_dat", "h_JMBMB_dat",22, new_bins_const,100, new_bins);
      fOutput->Add(h_JMBMB_dat);
-     h_JMBMB_tru = new TH3D("h_JMBMB_tru", "h_JMBMB_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_JMBMB_tru);
-     h_MB1MB1MB2 = new TH3D("h_MB1MB1MB2", "h_MB1MB1MB2",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB1MB2);
      h_MB1MB1MB2_dat = new TH2D("h_MB1MB1MB2_dat", "h_MB1MB1MB2_dat",22, new_bins_const,100, new_bins);
      fOutput->Add(h_MB1MB1MB2_dat);
-     h_MB1MB1MB2_tru = new TH3D("h_MB1MB1MB2_tru", "h_MB1MB1MB2_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB1MB2_tru);
-     h_MB1MB2MB2 = new TH3D("h_MB1MB2MB2", "h_MB1MB2MB2",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB2MB2);
      h_MB1MB2MB2_dat = new TH2D("h_MB1MB2MB2_dat", "h_MB1MB2MB2_dat",22, new_bins_const,100, new_bins);
      fOutput->Add(h_MB1MB2MB2_dat);
-     h_MB1MB2MB2_tru = new TH3D("h_MB1MB2MB2_tru", "h_MB1MB2MB2_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB2MB2_tru);
 
-    if(fCout) cout<<"subtraction histograms for E3C 3"<<endl; 
+    E3C_LOG_SETUP("subtraction histograms for E3C 3");
 
-     h_JMB1MB2 = new TH3D("h_JMB1MB2", "h_JMB1MB2", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_JMB1MB2);
      h_JMB1MB2_dat = new TH2D("h_JMB1MB2_dat", "h_JMB1MB2_dat", 22, new_bins_const,100, new_bins);
      fOutput->Add(h_JMB1MB2_dat);
-     h_JMB1MB2_tru = new TH3D("h_JMB1MB2_tru", "h_JMB1MB2_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_JMB1MB2_tru);
-     h_MB1MB2MB3 = new TH3D("h_MB1MB2MB3", "h_MB1MB2MB3",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB2MB3);
      h_MB1MB2MB3_dat = new TH2D("h_MB1MB2MB3_dat", "h_MB1MB2MB3_dat",22, new_bins_const,100, new_bins);
      fOutput->Add(h_MB1MB2MB3_dat);
-     h_MB1MB2MB3_tru = new TH3D("h_MB1MB2MB3_tru", "h_MB1MB2MB3_tru",22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_MB1MB2MB3_tru);
-
-    if(fCout) cout<<"subtraction histograms for E3C 4"<<endl; 
-
-     h_BMBMB = new TH3D("h_BMBMB", "h_BMBMB", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_BMBMB);
-     h_SMBMB = new TH3D("h_SMBMB", "h_SMBMB", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SMBMB);
-     h_BMB1MB2 = new TH3D("h_BMB1MB2", "h_BMB1MB2", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_BMB1MB2);
-     h_SMB1MB2 = new TH3D("h_SMB1MB2", "h_SMB1MB2", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SMB1MB2);
-     h_BBMB = new TH3D("h_BBMB", "h_BBMB", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_BBMB);
-     h_SBMB = new TH3D("h_SBMB", "h_SBMB", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SBMB);
-     h_SSMB = new TH3D("h_SSMB", "h_SSMB", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SSMB);
-
-if(fCout) cout<<"subtraction histograms for E3C 5"<<endl;
 
-     h_BMBMB_tru = new TH3D("h_BMBMB_tru", "h_BMBMB_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_BMBMB_tru);
-     h_SMBMB_tru = new TH3D("h_SMBMB_tru", "h_SMBMB_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SMBMB_tru);
-     h_BMB1MB2_tru = new TH3D("h_BMB1MB2_tru", "h_BMB1MB2_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_BMB1MB2_tru);
-     h_BBMB_tru = new TH3D("h_BBMB_tru", "h_BBMB_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_BBMB_tru);
-     h_SBMB_tru = new TH3D("h_SBMB_tru", "h_SBMB_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SBMB_tru);
-     h_SSMB_tru = new TH3D("h_SSMB_tru", "h_SSMB_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SSMB_tru);
-     h_SMB1MB2_tru = new TH3D("h_SMB1MB2_tru", "h_SMB1MB2_tru", 22, new_bins_const,22, new_bins_const,100, new_bins);
-     fOutput->Add(h_SMB1MB2_tru);
-
-
-if(fCout)cout<<"#####################---Declaring 3D Embedding Histograms E3C----####################"<<endl;
-
-    h3Jet_deltaR_MJ_e3c = new TH3D("h3Jet_deltaR_MJ_e3c", "h3Jet_deltaR_MJ_e3c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c);
-    h3Jet_deltaR_MJ0_e3c = new TH3D("h3Jet_deltaR_MJ0_e3c", "h3Jet_deltaR_MJ0_e3c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c);
-    h3Jet_deltaR_MJ1_e3c = new TH3D("h3Jet_deltaR_MJ1_e3c", "h3Jet_deltaR_MJ1_e3c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c);
-    h3Jet_deltaR_MJ2_e3c = new TH3D("h3Jet_deltaR_MJ2_e3c", "h3Jet_deltaR_MJ2_e3c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c);
-    h3Jet_deltaR_MJ3_e3c = new TH3D("h3Jet_deltaR_MJ3_e3c", "h3Jet_deltaR_MJ3_e3c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c);
-    
-    h3_MB1MB1MB1 = new TH3D("h3_MB1MB1MB1", "h3_MB1MB1MB1",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB1);
-    h3_JJMB = new TH3D("h3_JJMB", "h3_JJMB", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JJMB);
-    h3_JMBMB = new TH3D("h3_JMBMB", "h3_JMBMB",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMBMB);
-    h3_MB1MB1MB2 = new TH3D("h3_MB1MB1MB2", "h3_MB1MB1MB2",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB2);
-    h3_MB1MB2MB2 = new TH3D("h3_MB1MB2MB2", "h3_MB1MB2MB2",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB2);
-    h3_JMB1MB2 = new TH3D("h3_JMB1MB2", "h3_JMB1MB2", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMB1MB2);
-    h3_MB1MB2MB3 = new TH3D("h3_MB1MB2MB3", "h3_MB1MB2MB3",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB3);
-    h3_BMBMB = new TH3D("h3_BMBMB", "h3_BMBMB", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMBMB);
-    h3_SMBMB = new TH3D("h3_SMBMB", "h3_SMBMB", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMBMB);
-    h3_BMB1MB2 = new TH3D("h3_BMB1MB2", "h3_BMB1MB2", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMB1MB2);
-    h3_SMB1MB2 = new TH3D("h3_SMB1MB2", "h3_SMB1MB2", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMB1MB2);
-    h3_BBMB = new TH3D("h3_BBMB", "h3_BBMB", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BBMB);
-    h3_SBMB = new TH3D("h3_SBMB", "h3_SBMB", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SBMB);
-    h3_SSMB = new TH3D("h3_SSMB", "h3_SSMB", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SSMB);
-    
-    
-    h3Jet_deltaR_MJ_e3c_tru = new TH3D("h3Jet_deltaR_MJ_e3c_tru", "h3Jet_deltaR_MJ_e3c_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h_MJ_e3c_tru);
-    h3Jet_deltaR_MJ0_e3c_tru = new TH3D("h3Jet_deltaR_MJ0_e3c_tru", "h3Jet_deltaR_MJ0_e3c_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h_MJ0_e3c_tru);
-    h3Jet_deltaR_MJ1_e3c_tru = new TH3D("h3Jet_deltaR_MJ1_e3c_tru", "h3Jet_deltaR_MJ1_e3c_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h_MJ1_e3c_tru);
-    h3Jet_deltaR_MJ2_e3c_tru = new TH3D("h3Jet_deltaR_MJ2_e3c_tru", "h3Jet_deltaR_MJ2_e3c_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h_MJ2_e3c_tru);
-    h3Jet_deltaR_MJ3_e3c_tru = new TH3D("h3Jet_deltaR_MJ3_e3c_tru", "h3Jet_deltaR_MJ3_e3c_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h_MJ3_e3c_tru);
-    h3_MB1MB1MB1_tru = new TH3D("h3_MB1MB1MB1_tru", "h3_MB1MB1MB1_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB1_tru);
-    h3_JJMB_tru = new TH3D("h3_JJMB_tru", "h3_JJMB_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JJMB_tru);
-    h3_JMBMB_tru = new TH3D("h3_JMBMB_tru", "h3_JMBMB_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMBMB_tru);
-    h3_MB1MB1MB2_tru = new TH3D("h3_MB1MB1MB2_tru", "h3_MB1MB1MB2_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB2_tru);
-    h3_MB1MB2MB2_tru = new TH3D("h3_MB1MB2MB2_tru", "h3_MB1MB2MB2_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB2_tru);
-    h3_JMB1MB2_tru = new TH3D("h3_JMB1MB2_tru", "h3_JMB1MB2_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMB1MB2_tru);
-    h3_MB1MB2MB3_tru = new TH3D("h3_MB1MB2MB3_tru", "h3_MB1MB2MB3_tru",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB3_tru);
-    h3_BMBMB_tru = new TH3D("h3_BMBMB_tru", "h3_BMBMB_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMBMB_tru);
-    h3_SMBMB_tru = new TH3D("h3_SMBMB_tru", "h3_SMBMB_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMBMB_tru);
-    h3_BMB1MB2_tru = new TH3D("h3_BMB1MB2_tru", "h3_BMB1MB2_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMB1MB2_tru);
-    h3_BBMB_tru = new TH3D("h3_BBMB_tru", "h3_BBMB_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BBMB_tru);
-    h3_SBMB_tru = new TH3D("h3_SBMB_tru", "h3_SBMB_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SBMB_tru);
-    h3_SSMB_tru = new TH3D("h3_SSMB_tru", "h3_SSMB_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SSMB_tru);
-    h3_SMB1MB2_tru = new TH3D("h3_SMB1MB2_tru", "h3_SMB1MB2_tru", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMB1MB2_tru);
-    
-    //c-factor
-    h3Jet_deltaR_MJ_e3c_c = new TH3D("h3Jet_deltaR_MJ_e3c_c", "h3Jet_deltaR_MJ_e3c_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_c);
-    h3Jet_deltaR_MJ0_e3c_c = new TH3D("h3Jet_deltaR_MJ0_e3c_c", "h3Jet_deltaR_MJ0_e3c_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_c);
-    h3Jet_deltaR_MJ1_e3c_c = new TH3D("h3Jet_deltaR_MJ1_e3c_c", "h3Jet_deltaR_MJ1_e3c_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_c);
-    h3Jet_deltaR_MJ2_e3c_c = new TH3D("h3Jet_deltaR_MJ2_e3c_c", "h3Jet_deltaR_MJ2_e3c_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_c);
-    h3Jet_deltaR_MJ3_e3c_c = new TH3D("h3Jet_deltaR_MJ3_e3c_c", "h3Jet_deltaR_MJ3_e3c_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_c);
-    h3_MB1MB1MB1_c = new TH3D("h3_MB1MB1MB1_c", "h3_MB1MB1MB1_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB1_c);
-    h3_JJMB_c = new TH3D("h3_JJMB_c", "h3_JJMB_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JJMB_c);
-    h3_JMBMB_c = new TH3D("h3_JMBMB_c", "h3_JMBMB_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMBMB_c);
-    h3_MB1MB1MB2_c = new TH3D("h3_MB1MB1MB2_c", "h3_MB1MB1MB2_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB2_c);
-    h3_MB1MB2MB2_c = new TH3D("h3_MB1MB2MB2_c", "h3_MB1MB2MB2_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB2_c);
-    h3_JMB1MB2_c = new TH3D("h3_JMB1MB2_c", "h3_JMB1MB2_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMB1MB2_c);
-    h3_MB1MB2MB3_c = new TH3D("h3_MB1MB2MB3_c", "h3_MB1MB2MB3_c",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB3_c);
-    h3_BMBMB_c = new TH3D("h3_BMBMB_c", "h3_BMBMB_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMBMB_c);
-    h3_SMBMB_c = new TH3D("h3_SMBMB_c", "h3_SMBMB_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMBMB_c);
-    h3_BMB1MB2_c = new TH3D("h3_BMB1MB2_c", "h3_BMB1MB2_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMB1MB2_c);
-    h3_SMB1MB2_c = new TH3D("h3_SMB1MB2_c", "h3_SMB1MB2_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMB1MB2_c);
-    h3_BBMB_c = new TH3D("h3_BBMB_c", "h3_BBMB_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BBMB_c);
-    h3_SBMB_c = new TH3D("h3_SBMB_c", "h3_SBMB_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SBMB_c);
-    h3_SSMB_c = new TH3D("h3_SSMB_c", "h3_SSMB_c", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SSMB_c);
-    
-    
-    //########################-------Matched jets ONLY--------###########################
-    h3Jet_deltaR_MJ_e3c_m = new TH3D("h3Jet_deltaR_MJ_e3c_m", "h3Jet_deltaR_MJ_e3c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_m);
-    h3Jet_deltaR_MJ0_e3c_m = new TH3D("h3Jet_deltaR_MJ0_e3c_m", "h3Jet_deltaR_MJ0_e3c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_m);
-    h3Jet_deltaR_MJ1_e3c_m = new TH3D("h3Jet_deltaR_MJ1_e3c_m", "h3Jet_deltaR_MJ1_e3c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_m);
-    h3Jet_deltaR_MJ2_e3c_m = new TH3D("h3Jet_deltaR_MJ2_e3c_m", "h3Jet_deltaR_MJ2_e3c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_m);
-    h3Jet_deltaR_MJ3_e3c_m = new TH3D("h3Jet_deltaR_MJ3_e3c_m", "h3Jet_deltaR_MJ3_e3c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_m);
-    h3_MB1MB1MB1_m = new TH3D("h3_MB1MB1MB1_m", "h3_MB1MB1MB1_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB1_m);
-    h3_JJMB_m = new TH3D("h3_JJMB_m", "h3_JJMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JJMB_m);
-    h3_JMBMB_m = new TH3D("h3_JMBMB_m", "h3_JMBMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMBMB_m);
-    h3_MB1MB1MB2_m = new TH3D("h3_MB1MB1MB2_m", "h3_MB1MB1MB2_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB2_m);
-    h3_MB1MB2MB2_m = new TH3D("h3_MB1MB2MB2_m", "h3_MB1MB2MB2_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB2_m);
-    h3_JMB1MB2_m = new TH3D("h3_JMB1MB2_m", "h3_JMB1MB2_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMB1MB2_m);
-    h3_MB1MB2MB3_m = new TH3D("h3_MB1MB2MB3_m", "h3_MB1MB2MB3_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB3_m);
-    h3_BMBMB_m = new TH3D("h3_BMBMB_m", "h3_BMBMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMBMB_m);
-    h3_SMBMB_m = new TH3D("h3_SMBMB_m", "h3_SMBMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMBMB_m);
-    h3_BMB1MB2_m = new TH3D("h3_BMB1MB2_m", "h3_BMB1MB2_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMB1MB2_m);
-    h3_SMB1MB2_m = new TH3D("h3_SMB1MB2_m", "h3_SMB1MB2_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMB1MB2_m);
-    h3_BBMB_m = new TH3D("h3_BBMB_m", "h3_BBMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BBMB_m);
-    h3_SBMB_m = new TH3D("h3_SBMB_m", "h3_SBMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SBMB_m);
-    h3_SSMB_m = new TH3D("h3_SSMB_m", "h3_SSMB_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SSMB_m);
-    
-    h3Jet_deltaR_MJ_e3c_tru_m = new TH3D("h3Jet_deltaR_MJ_e3c_tru_m", "h3Jet_deltaR_MJ_e3c_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_tru_m);
-    h3Jet_deltaR_MJ0_e3c_tru_m = new TH3D("h3Jet_deltaR_MJ0_e3c_tru_m", "h3Jet_deltaR_MJ0_e3c_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_tru_m);
-    h3Jet_deltaR_MJ1_e3c_tru_m = new TH3D("h3Jet_deltaR_MJ1_e3c_tru_m", "h3Jet_deltaR_MJ1_e3c_tru_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_tru_m);
-    h3Jet_deltaR_MJ2_e3c_tru_m = new TH3D("h3Jet_deltaR_MJ2_e3c_tru_m", "h3Jet_deltaR_MJ2_e3c_tru_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_tru_m);
-    h3Jet_deltaR_MJ3_e3c_tru_m = new TH3D("h3Jet_deltaR_MJ3_e3c_tru_m", "h3Jet_deltaR_MJ3_e3c_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_tru_m);
-    h3_JJMB_tru_m = new TH3D("h3_JJMB_tru_m", "h3_JJMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JJMB_tru_m);
-    h3_JMBMB_tru_m = new TH3D("h3_JMBMB_tru_m", "h3_JMBMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMBMB_tru_m);
-    h3_MB1MB1MB2_tru_m = new TH3D("h3_MB1MB1MB2_tru_m", "h3_MB1MB1MB2_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB2_tru_m);
-    h3_MB1MB2MB2_tru_m = new TH3D("h3_MB1MB2MB2_tru_m", "h3_MB1MB2MB2_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB2_tru_m);
-    h3_JMB1MB2_tru_m = new TH3D("h3_JMB1MB2_tru_m", "h3_JMB1MB2_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMB1MB2_tru_m);
-    h3_MB1MB2MB3_tru_m = new TH3D("h3_MB1MB2MB3_tru_m", "h3_MB1MB2MB3_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB3_tru_m);
-    h3_BMBMB_tru_m = new TH3D("h3_BMBMB_tru_m", "h3_BMBMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMBMB_tru_m);
-    h3_SMBMB_tru_m = new TH3D("h3_SMBMB_tru_m", "h3_SMBMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMBMB_tru_m);
-    h3_BMB1MB2_tru_m = new TH3D("h3_BMB1MB2_tru_m", "h3_BMB1MB2_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMB1MB2_tru_m);
-    h3_BBMB_tru_m = new TH3D("h3_BBMB_tru_m", "h3_BBMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BBMB_tru_m);
-    h3_SBMB_tru_m = new TH3D("h3_SBMB_tru_m", "h3_SBMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SBMB_tru_m);
-    h3_SSMB_tru_m = new TH3D("h3_SSMB_tru_m", "h3_SSMB_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SSMB_tru_m);
-    h3_SMB1MB2_tru_m = new TH3D("h3_SMB1MB2_tru_m", "h3_SMB1MB2_tru_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMB1MB2_tru_m);
-    
-    //c-factor
-    h3Jet_deltaR_MJ_e3c_c_m = new TH3D("h3Jet_deltaR_MJ_e3c_c_m", "h3Jet_deltaR_MJ_e3c_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_c_m);
-    h3Jet_deltaR_MJ0_e3c_c_m = new TH3D("h3Jet_deltaR_MJ0_e3c_c_m", "h3Jet_deltaR_MJ0_e3c_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_c_m);
-    h3Jet_deltaR_MJ1_e3c_c_m = new TH3D("h3Jet_deltaR_MJ1_e3c_c_m", "h3Jet_deltaR_MJ1_e3c_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_c_m);
-    h3Jet_deltaR_MJ2_e3c_c_m = new TH3D("h3Jet_deltaR_MJ2_e3c_c_m", "h3Jet_deltaR_MJ2_e3c_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_c_m);
-    h3Jet_deltaR_MJ3_e3c_c_m = new TH3D("h3Jet_deltaR_MJ3_e3c_c_m", "h3Jet_deltaR_MJ3_e3c_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_c_m);
-    h3_MB1MB1MB1_c_m = new TH3D("h3_MB1MB1MB1_c_m", "h3_MB1MB1MB1_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB1_c_m);
-    h3_JJMB_c_m = new TH3D("h3_JJMB_c_m", "h3_JJMB_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JJMB_c_m);
-    h3_JMBMB_c_m = new TH3D("h3_JMBMB_c_m", "h3_JMBMB_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMBMB_c_m);
-    h3_MB1MB1MB2_c_m = new TH3D("h3_MB1MB1MB2_c_m", "h3_MB1MB1MB2_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB2_c_m);
-    h3_MB1MB2MB2_c_m = new TH3D("h3_MB1MB2MB2_c_m", "h3_MB1MB2MB2_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB2_c_m);
-    h3_JMB1MB2_c_m = new TH3D("h3_JMB1MB2_c_m", "h3_JMB1MB2_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMB1MB2_c_m);
-    h3_MB1MB2MB3_c_m = new TH3D("h3_MB1MB2MB3_c_m", "h3_MB1MB2MB3_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB3_c_m);
-    h3_BMBMB_c_m = new TH3D("h3_BMBMB_c_m", "h3_BMBMB_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMBMB_c_m);
-    h3_SMBMB_c_m = new TH3D("h3_SMBMB_c_m", "h3_SMBMB_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMBMB_c_m);
-    h3_BMB1MB2_c_m = new TH3D("h3_BMB1MB2_c_m", "h3_BMB1MB2_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMB1MB2_c_m);
-    h3_SMB1MB2_c_m = new TH3D("h3_SMB1MB2_c_m", "h3_SMB1MB2_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMB1MB2_c_m);
-    h3_BBMB_c_m = new TH3D("h3_BBMB_c_m", "h3_BBMB_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BBMB_c_m);
-    h3_SBMB_c_m = new TH3D("h3_SBMB_c_m", "h3_SBMB_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SBMB_c_m);
-    h3_SSMB_c_m = new TH3D("h3_SSMB_c_m", "h3_SSMB_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SSMB_c_m);
-    
-    h3Jet_deltaR_MJ_e3c_tru_c_m = new TH3D("h3Jet_deltaR_MJ_e3c_tru_c_m", "h3Jet_deltaR_MJ_e3c_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_tru_c_m);
-    h3Jet_deltaR_MJ0_e3c_tru_c_m = new TH3D("h3Jet_deltaR_MJ0_e3c_tru_c_m", "h3Jet_deltaR_MJ0_e3c_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_tru_c_m);
-    h3Jet_deltaR_MJ1_e3c_tru_c_m = new TH3D("h3Jet_deltaR_MJ1_e3c_tru_c_m", "h3Jet_deltaR_MJ1_e3c_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_tru_c_m);
-    h3Jet_deltaR_MJ2_e3c_tru_c_m = new TH3D("h3Jet_deltaR_MJ2_e3c_tru_c_m", "h3Jet_deltaR_MJ2_e3c_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_tru_c_m);
-    h3Jet_deltaR_MJ3_e3c_tru_c_m = new TH3D("h3Jet_deltaR_MJ3_e3c_tru_c_m", "h3Jet_deltaR_MJ3_e3c_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_tru_c_m);
-    
-    h3_MB1MB1MB1_tru_c_m = new TH3D("h3_MB1MB1MB1_tru_c_m", "h3_MB1MB1MB1_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB1_tru_c_m);
-    h3_JJMB_tru_c_m = new TH3D("h3_JJMB_tru_c_m", "h3_JJMB_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JJMB_tru_c_m);
-    h3_JMBMB_tru_c_m = new TH3D("h3_JMBMB_tru_c_m", "h3_JMBMB_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMBMB_tru_c_m);
-    h3_MB1MB1MB2_tru_c_m = new TH3D("h3_MB1MB1MB2_tru_c_m", "h3_MB1MB1MB2_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB1MB2_tru_c_m);
-    h3_MB1MB2MB2_tru_c_m = new TH3D("h3_MB1MB2MB2_tru_c_m", "h3_MB1MB2MB2_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB2_tru_c_m);
-    h3_JMB1MB2_tru_c_m = new TH3D("h3_JMB1MB2_tru_c_m", "h3_JMB1MB2_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_JMB1MB2_tru_c_m);
-    h3_MB1MB2MB3_tru_c_m = new TH3D("h3_MB1MB2MB3_tru_c_m", "h3_MB1MB2MB3_tru_c_m",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_MB1MB2MB3_tru_c_m);
-    h3_BMBMB_tru_c_m = new TH3D("h3_BMBMB_tru_c_m", "h3_BMBMB_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMBMB_tru_c_m);
-    h3_SMBMB_tru_c_m = new TH3D("h3_SMBMB_tru_c_m", "h3_SMBMB_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMBMB_tru_c_m);
-    h3_BMB1MB2_tru_c_m = new TH3D("h3_BMB1MB2_tru_c_m", "h3_BMB1MB2_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BMB1MB2_tru_c_m);
-    h3_SMB1MB2_tru_c_m = new TH3D("h3_SMB1MB2_tru_c_m", "h3_SMB1MB2_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SMB1MB2_tru_c_m);
-    h3_BBMB_tru_c_m = new TH3D("h3_BBMB_tru_c_m", "h3_BBMB_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_BBMB_tru_c_m);
-    h3_SBMB_tru_c_m = new TH3D("h3_SBMB_tru_c_m", "h3_SBMB_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SBMB_tru_c_m);
-    h3_SSMB_tru_c_m = new TH3D("h3_SSMB_tru_c_m", "h3_SSMB_tru_c_m", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3_SSMB_tru_c_m);
-
-
-    //########################-------Unmatched jets ONLY--------###########################
-    h3Jet_deltaR_MJ_e3c_um = new TH3D("h3Jet_deltaR_MJ_e3c_um", "h3Jet_deltaR_MJ_e3c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_um);
-    h3Jet_deltaR_MJ0_e3c_um = new TH3D("h3Jet_deltaR_MJ0_e3c_um", "h3Jet_deltaR_MJ0_e3c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_um);
-    h3Jet_deltaR_MJ1_e3c_um = new TH3D("h3Jet_deltaR_MJ1_e3c_um", "h3Jet_deltaR_MJ1_e3c_um",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_um);
-    h3Jet_deltaR_MJ2_e3c_um = new TH3D("h3Jet_deltaR_MJ2_e3c_um", "h3Jet_deltaR_MJ2_e3c_um",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_um);
-    h3Jet_deltaR_MJ3_e3c_um = new TH3D("h3Jet_deltaR_MJ3_e3c_um", "h3Jet_deltaR_MJ3_e3c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_um);
-    
-    h3_MB1MB1MB1_um = new TH3D("h3_MB1MB1MB1_um", "h3_MB1MB1MB1_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB1_um);
-    h3_JJMB_um = new TH3D("h3_JJMB_um", "h3_JJMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JJMB_um);
-    h3_JMBMB_um = new TH3D("h3_JMBMB_um", "h3_JMBMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMBMB_um);
-    h3_MB1MB1MB2_um = new TH3D("h3_MB1MB1MB2_um", "h3_MB1MB1MB2_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB2_um);
-    h3_MB1MB2MB2_um = new TH3D("h3_MB1MB2MB2_um", "h3_MB1MB2MB2_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB2_um);
-    h3_JMB1MB2_um = new TH3D("h3_JMB1MB2_um", "h3_JMB1MB2_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMB1MB2_um);
-    h3_MB1MB2MB3_um = new TH3D("h3_MB1MB2MB3_um", "h3_MB1MB2MB3_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB3_um);
-    h3_BMBMB_um = new TH3D("h3_BMBMB_um", "h3_BMBMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMBMB_um);
-    h3_SMBMB_um = new TH3D("h3_SMBMB_um", "h3_SMBMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMBMB_um);
-    h3_BMB1MB2_um = new TH3D("h3_BMB1MB2_um", "h3_BMB1MB2_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMB1MB2_um);
-    h3_SMB1MB2_um = new TH3D("h3_SMB1MB2_um", "h3_SMB1MB2_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMB1MB2_um);
-    h3_BBMB_um = new TH3D("h3_BBMB_um", "h3_BBMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BBMB_um);
-    h3_SBMB_um = new TH3D("h3_SBMB_um", "h3_SBMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SBMB_um);
-    h3_SSMB_um = new TH3D("h3_SSMB_um", "h3_SSMB_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SSMB_um);
-    
-    h3_JJMB_tru_um = new TH3D("h3_JJMB_tru_um", "h3_JJMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JJMB_tru_um);
-    h3_JMBMB_tru_um = new TH3D("h3_JMBMB_tru_um", "h3_JMBMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMBMB_tru_um);
-    h3_MB1MB1MB2_tru_um = new TH3D("h3_MB1MB1MB2_tru_um", "h3_MB1MB1MB2_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB2_tru_um);
-    h3_MB1MB2MB2_tru_um = new TH3D("h3_MB1MB2MB2_tru_um", "h3_MB1MB2MB2_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB2_tru_um);
-    h3_JMB1MB2_tru_um = new TH3D("h3_JMB1MB2_tru_um", "h3_JMB1MB2_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMB1MB2_tru_um);
-    h3_MB1MB2MB3_tru_um = new TH3D("h3_MB1MB2MB3_tru_um", "h3_MB1MB2MB3_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB3_tru_um);
-    h3_BMBMB_tru_um = new TH3D("h3_BMBMB_tru_um", "h3_BMBMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMBMB_tru_um);
-    h3_SMBMB_tru_um = new TH3D("h3_SMBMB_tru_um", "h3_SMBMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMBMB_tru_um);
-    h3_BMB1MB2_tru_um = new TH3D("h3_BMB1MB2_tru_um", "h3_BMB1MB2_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMB1MB2_tru_um);
-    h3_BBMB_tru_um = new TH3D("h3_BBMB_tru_um", "h3_BBMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BBMB_tru_um);
-    h3_SBMB_tru_um = new TH3D("h3_SBMB_tru_um", "h3_SBMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SBMB_tru_um);
-    h3_SSMB_tru_um = new TH3D("h3_SSMB_tru_um", "h3_SSMB_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SSMB_tru_um);
-    h3_SMB1MB2_tru_um = new TH3D("h3_SMB1MB2_tru_um", "h3_SMB1MB2_tru_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMB1MB2_tru_um);
-    
-    
-    //c-factor
-    h3Jet_deltaR_MJ_e3c_c_um = new TH3D("h3Jet_deltaR_MJ_e3c_c_um", "h3Jet_deltaR_MJ_e3c_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_c_um);
-    h3Jet_deltaR_MJ0_e3c_c_um = new TH3D("h3Jet_deltaR_MJ0_e3c_c_um", "h3Jet_deltaR_MJ0_e3c_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_c_um);
-    h3Jet_deltaR_MJ1_e3c_c_um = new TH3D("h3Jet_deltaR_MJ1_e3c_c_um", "h3Jet_deltaR_MJ1_e3c_c_um",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_c_um);
-    h3Jet_deltaR_MJ2_e3c_c_um = new TH3D("h3Jet_deltaR_MJ2_e3c_c_um", "h3Jet_deltaR_MJ2_e3c_c_um",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_c_um);
-    h3Jet_deltaR_MJ3_e3c_c_um = new TH3D("h3Jet_deltaR_MJ3_e3c_c_um", "h3Jet_deltaR_MJ3_e3c_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_c_um);
+    E3C_LOG_SETUP("#####################---Declaring 3D Embedding Histograms E3C----####################");
+
+    //E3C histogram bank: every family routed by ComputeE3C and selected by SetE3CFamilies, one axis set per family and
+    //[category][variant] in E3CCategory/E3CVariant order. Filled in place during the run and
+    //written to fOutput as TH3D (same names as before) and TH2D (hw moments) in FinishTaskOutput.
+    //The moments share the (jet pT, R_L) binning of the h3 families without the weight axis
+    fE3CHists.Clear();
+    for (int c = 0; c < kE3CNCategories; c++) {
+        fE3CHists.SetAxes(kE3CResponse, c, 22, new_bins_const, 22, new_bins_const, 100, new_bins);
+        fE3CHists.SetAxes(kE3CWeightAxis, c, nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
+        fE3CHists.SetAxes(kE3CMoments, c, nJetPtbins, xbins, ndRbins, dRbins);
+        for (int v = 0; v < kE3CNVariants; v++) {
+            if (fE3CFamilies.Selected(kE3CResponse, c, v)) fE3CHists.Book(kE3CResponse, c, v);
+            if (fE3CFamilies.Selected(kE3CMoments, c, v)) fE3CHists.Book(kE3CMoments, c, v);
+            if (c == kE3CMB1MB1MB1 && v == kE3CTruM) continue; //h3_MB1MB1MB1_tru_m was never booked
+            if (fE3CFamilies.Selected(kE3CWeightAxis, c, v)) fE3CHists.Book(kE3CWeightAxis, c, v);
+        }
+        for (int k = 0; k < kE3CNKinds; k++) {
+            fE3CHists.SetSingle(k, c, fE3CPrecision.Single(k, c));
+            fE3CHists.SetSparse(k, c, fE3CSparse.Sparse(k, c));
+        }
+    }
+    fE3CHists.validate = fE3CPrecision.validate;
+    fE3CHists.Allocate();
+    //nested thermal cones (SetE3CConeRadii): fConeR and the extra radii, ascending. fE3CHists holds
+    //fConeR; every other radius gets a copy of the booked families with a thermal-cone particle
+    fE3CNRadii = 0;
+    fE3CRadii[fE3CNRadii++] = fConeR;
+    for (double R : fE3CConeRadii)
+        if (fE3CNRadii < kE3CMaxRadii && std::find(fE3CRadii, fE3CRadii + fE3CNRadii, R) == fE3CRadii + fE3CNRadii) fE3CRadii[fE3CNRadii++] = R;
+    std::sort(fE3CRadii, fE3CRadii + fE3CNRadii);
+    fE3CMainRadius = std::find(fE3CRadii, fE3CRadii + fE3CNRadii, fConeR) - fE3CRadii;
+    fE3CRadiusHists.assign(fE3CNRadii, E3CHistBank());
+    for (int r = 0; r < fE3CNRadii; r++) {
+        fE3CRadiusBank[r] = r == fE3CMainRadius ? &fE3CHists : &fE3CRadiusHists[r];
+        if (r == fE3CMainRadius) continue;
+        E3CHistBank &bank = fE3CRadiusHists[r];
+        for (int c = kE3CMB1MB1MB1; c < kE3CNCategories; c++) {
+            bank.SetAxes(kE3CResponse, c, 22, new_bins_const, 22, new_bins_const, 100, new_bins);
+            bank.SetAxes(kE3CWeightAxis, c, nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
+            bank.SetAxes(kE3CMoments, c, nJetPtbins, xbins, ndRbins, dRbins);
+            for (int k = 0; k < kE3CNKinds; k++) {
+                for (int v = 0; v < kE3CNVariants; v++)
+                    if (fE3CHists.Booked(k, c, v)) bank.Book(k, c, v);
+                bank.SetSingle(k, c, fE3CPrecision.Single(k, c));
+                bank.SetSparse(k, c, fE3CSparse.Sparse(k, c));
+            }
+        }
+        bank.Allocate();
+    }
+    //N-point correlators (AddE3CENCFamily): one bank per order, family f of the order in category
+    //slot f, with the response binning and the variants selected by SetE3CFamilies
+    fE3CENC.Build();
+    for (int n = 0; n <= kE3CMaxOrder; n++) {
+        E3CHistBank &bank = fE3CENCHists[n];
+        fE3CENCBank[n] = &bank;
+        bank.Clear();
+        for (int f = 0; f < (int)fE3CENC.labels[n].size(); f++) {
+            bank.SetAxes(kE3CResponse, f, 22, new_bins_const, 22, new_bins_const, 100, new_bins);
+            for (int v = 0; v < kE3CNVariants; v++)
+                if (fE3CFamilies.AnyVariant(1u << v)) bank.Book(kE3CResponse, f, v);
+        }
+        bank.Allocate();
+    }
+    if (fE3CPrecision.validate) {
+        //filled in FinishTaskOutput with the maximum over the radii, 0 for families kept in double only
+        fHistE3CFloatDeviation = new TH2D("hE3CFloatDeviation", "hE3CFloatDeviation;kind*19+category;variant;max relative deviation float vs double",
+                                          kE3CNKinds * kE3CNCategories, -0.5, kE3CNKinds * kE3CNCategories - 0.5, kE3CNVariants, -0.5, kE3CNVariants - 0.5);
+        fOutput->Add(fHistE3CFloatDeviation);
+    }
 
-    
-    h3_MB1MB1MB1_c_um = new TH3D("h3_MB1MB1MB1_c_um", "h3_MB1MB1MB1_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB1_c_um);
-    h3_JJMB_c_um = new TH3D("h3_JJMB_c_um", "h3_JJMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JJMB_c_um);
-    h3_JMBMB_c_um = new TH3D("h3_JMBMB_c_um", "h3_JMBMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMBMB_c_um);
-    h3_MB1MB1MB2_c_um = new TH3D("h3_MB1MB1MB2_c_um", "h3_MB1MB1MB2_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB2_c_um);
-    h3_MB1MB2MB2_c_um = new TH3D("h3_MB1MB2MB2_c_um", "h3_MB1MB2MB2_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB2_c_um);
-    h3_JMB1MB2_c_um = new TH3D("h3_JMB1MB2_c_um", "h3_JMB1MB2_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMB1MB2_c_um);
-    h3_MB1MB2MB3_c_um = new TH3D("h3_MB1MB2MB3_c_um", "h3_MB1MB2MB3_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB3_c_um);
-    h3_BMBMB_c_um = new TH3D("h3_BMBMB_c_um", "h3_BMBMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMBMB_c_um);
-    h3_SMBMB_c_um = new TH3D("h3_SMBMB_c_um", "h3_SMBMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMBMB_c_um);
-    h3_BMB1MB2_c_um = new TH3D("h3_BMB1MB2_c_um", "h3_BMB1MB2_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMB1MB2_c_um);
-    h3_SMB1MB2_c_um = new TH3D("h3_SMB1MB2_c_um", "h3_SMB1MB2_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMB1MB2_c_um);
-    h3_BBMB_c_um = new TH3D("h3_BBMB_c_um", "h3_BBMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BBMB_c_um);
-    h3_SBMB_c_um = new TH3D("h3_SBMB_c_um", "h3_SBMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SBMB_c_um);
-    h3_SSMB_c_um = new TH3D("h3_SSMB_c_um", "h3_SSMB_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SSMB_c_um);
-    
-    h3Jet_deltaR_MJ_e3c_tru_c_um = new TH3D("h3Jet_deltaR_MJ_e3c_tru_c_um", "h3Jet_deltaR_MJ_e3c_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ_e3c_tru_c_um);
-    h3Jet_deltaR_MJ0_e3c_tru_c_um = new TH3D("h3Jet_deltaR_MJ0_e3c_tru_c_um", "h3Jet_deltaR_MJ0_e3c_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ0_e3c_tru_c_um);
-    h3Jet_deltaR_MJ1_e3c_tru_c_um = new TH3D("h3Jet_deltaR_MJ1_e3c_tru_c_um", "h3Jet_deltaR_MJ1_e3c_tru_c_um",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ1_e3c_tru_c_um);
-    h3Jet_deltaR_MJ2_e3c_tru_c_um = new TH3D("h3Jet_deltaR_MJ2_e3c_tru_c_um", "h3Jet_deltaR_MJ2_e3c_tru_c_um",nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ2_e3c_tru_c_um);
-    h3Jet_deltaR_MJ3_e3c_tru_c_um = new TH3D("h3Jet_deltaR_MJ3_e3c_tru_c_um", "h3Jet_deltaR_MJ3_e3c_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins,wtbins);
-    fOutput->Add(h3Jet_deltaR_MJ3_e3c_tru_c_um);
-    h3_MB1MB1MB1_tru_c_um = new TH3D("h3_MB1MB1MB1_tru_c_um", "h3_MB1MB1MB1_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB1_tru_c_um);
-    h3_JJMB_tru_c_um = new TH3D("h3_JJMB_tru_c_um", "h3_JJMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JJMB_tru_c_um);
-    h3_JMBMB_tru_c_um = new TH3D("h3_JMBMB_tru_c_um", "h3_JMBMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMBMB_tru_c_um);
-    h3_MB1MB1MB2_tru_c_um = new TH3D("h3_MB1MB1MB2_tru_c_um", "h3_MB1MB1MB2_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB1MB2_tru_c_um);
-    h3_MB1MB2MB2_tru_c_um = new TH3D("h3_MB1MB2MB2_tru_c_um", "h3_MB1MB2MB2_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB2_tru_c_um);
-    h3_JMB1MB2_tru_c_um = new TH3D("h3_JMB1MB2_tru_c_um", "h3_JMB1MB2_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_JMB1MB2_tru_c_um);
-    h3_MB1MB2MB3_tru_c_um = new TH3D("h3_MB1MB2MB3_tru_c_um", "h3_MB1MB2MB3_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_MB1MB2MB3_tru_c_um);
-    h3_BMBMB_tru_c_um = new TH3D("h3_BMBMB_tru_c_um", "h3_BMBMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMBMB_tru_c_um);
-    h3_SMBMB_tru_c_um = new TH3D("h3_SMBMB_tru_c_um", "h3_SMBMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMBMB_tru_c_um);
-    h3_BMB1MB2_tru_c_um = new TH3D("h3_BMB1MB2_tru_c_um", "h3_BMB1MB2_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BMB1MB2_tru_c_um);
-    h3_SMB1MB2_tru_c_um = new TH3D("h3_SMB1MB2_tru_c_um", "h3_SMB1MB2_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SMB1MB2_tru_c_um);
-    h3_BBMB_tru_c_um = new TH3D("h3_BBMB_tru_c_um", "h3_BBMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_BBMB_tru_c_um);
-    h3_SBMB_tru_c_um = new TH3D("h3_SBMB_tru_c_um", "h3_SBMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SBMB_tru_c_um);
-    h3_SSMB_tru_c_um = new TH3D("h3_SSMB_tru_c_um", "h3_SSMB_tru_c_um", nJetPtbins, xbins, ndRbins, dRbins, nWtbins, wtbins);
-    fOutput->Add(h3_SSMB_tru_c_um);
+    //E3C engine dispatch: thresholds not set in the AddTask (SetE3CEngineThreshold) take the fixed
+    //defaults, or are timed here with SetE3CEngineCalibration; the ones used go to hE3CEngineThreshold,
+    //calls and time per (mode, engine) are kept for auditing the choice
+    fE3CDispatch.forced = fE3CEngine;
+    fE3CDispatch.Configure(fE3CHists);
+    if (fE3CEngineCalibration) fE3CDispatch.Calibrate(fE3CWork);
+    fE3CDispatch.Defaults();
+    //bin lookups of the booked R_L and weight axes, after the calibration which runs on stand-ins
+    fE3CWork.acc.Configure(fE3CHists);
+    //helper threads of the parallel mode (SetE3CThreads), idle between events; fE3CParallel is a
+    //transient pointer, so the pool is only built here, on the worker, from the persistent settings
+    if (fE3CThreads > 1) {
+        fE3CParallel = new E3CParallel();
+        fE3CParallel->nThreads = fE3CThreads;
+        fE3CParallel->splitThreshold = fE3CSplitThreshold > 0 ? fE3CSplitThreshold : INT_MAX;
+        fE3CParallel->Start();
+    }
+    fHistE3CEngineThreshold = new TH1D("hE3CEngineThreshold", "hE3CEngineThreshold;mode;sorted-pair engine from multiplicity", kE3CNModes, -0.5, kE3CNModes - 0.5);
+    fOutput->Add(fHistE3CEngineThreshold);
+    fHistE3CEngineCalls = new TH2D("hE3CEngineCalls", "hE3CEngineCalls;mode;engine", kE3CNModes, -0.5, kE3CNModes - 0.5, kE3CNEngines, -0.5, kE3CNEngines - 0.5);
+    fOutput->Add(fHistE3CEngineCalls);
+    fHistE3CEngineTime = new TH2D("hE3CEngineTime", "hE3CEngineTime;mode;engine;time (#mus)", kE3CNModes, -0.5, kE3CNModes - 0.5, kE3CNEngines, -0.5, kE3CNEngines - 0.5);
+    fOutput->Add(fHistE3CEngineTime);
+    //per jet: samples of three thermal cones (FindMultipleThermalCones), to normalise the MB histograms
+    fHistE3CConeSamples = new TH1D("hE3CConeSamples", "hE3CConeSamples;cone samples per jet;jets", kE3CMaxCones / 3 + 1, -0.5, kE3CMaxCones / 3 + 0.5);
+    fOutput->Add(fHistE3CConeSamples);
+    //per event: particle blocks created or grown (E3CBlockPool), filled from the second event on
+    fHistE3CAllocations = new TH1D("hE3CAllocations", "hE3CAllocations;block allocations per event;events", 50, -0.5, 49.5);
+    fOutput->Add(fHistE3CAllocations);
+    if (fE3CConeCache.enabled) {
+        //set in FinishTaskOutput
+        fHistE3CConeCache = new TH1D("hE3CConeCache", "hE3CConeCache;;count", 4, -0.5, 3.5);
+        const char *labels[4] = {"cone lookups", "cone hits", "MB-term lookups", "MB-term hits"};
+        for (int b = 0; b < 4; b++) fHistE3CConeCache->GetXaxis()->SetBinLabel(b + 1, labels[b]);
+        fOutput->Add(fHistE3CConeCache);
+    }
+#if E3C_INSTRUMENT
+    //stage timers and counters (E3C_INSTRUMENT): time and calls per stage, time per call against the
+    //multiplicity of the call (tracks, constituents, cone tracks or E3CDispatcher::Multiplicity);
+    //the counters and the fills per family are set in FinishTaskOutput
+    fHistE3CStageTime = new TH1D("hE3CStageTime", "hE3CStageTime;;time (#mus)", kE3CNStages, -0.5, kE3CNStages - 0.5);
+    fHistE3CStageCalls = new TH1D("hE3CStageCalls", "hE3CStageCalls;;calls", kE3CNStages, -0.5, kE3CNStages - 0.5);
+    std::vector<double> multEdges;
+    for (int b = 0; b <= 50; b++) multEdges.push_back(0.5 * std::pow(10., 0.1 * b));
+    fHistE3CStageCost = new TProfile2D("hE3CStageCost", "hE3CStageCost;multiplicity;;time per call (#mus)",
+                                       50, multEdges.data(), kE3CNStages, -0.5, kE3CNStages - 0.5);
+    for (int st = 0; st < kE3CNStages; st++) {
+        fHistE3CStageTime->GetXaxis()->SetBinLabel(st + 1, kE3CStageName[st]);
+        fHistE3CStageCalls->GetXaxis()->SetBinLabel(st + 1, kE3CStageName[st]);
+        fHistE3CStageCost->GetYaxis()->SetBinLabel(st + 1, kE3CStageName[st]);
+    }
+    fHistE3CCounters = new TH1D("hE3CCounters", "hE3CCounters;;count", 3, -0.5, 2.5);
+    const char *counterLabels[3] = {"terms evaluated", "terms filled", "accumulator flushes"};
+    for (int b = 0; b < 3; b++) fHistE3CCounters->GetXaxis()->SetBinLabel(b + 1, counterLabels[b]);
+    fHistE3CFamilyFills = new TH2D("hE3CFamilyFills", "hE3CFamilyFills;kind*19+category;variant;entries",
+                                   kE3CNKinds * kE3CNCategories, -0.5, kE3CNKinds * kE3CNCategories - 0.5, kE3CNVariants, -0.5, kE3CNVariants - 0.5);
+    fHistE3CConeTracks = new TH1D("hE3CConeTracks", "hE3CConeTracks;tracks per thermal cone;cones", 200, -0.5, 199.5);
+    fOutput->Add(fHistE3CStageTime);
+    fOutput->Add(fHistE3CStageCalls);
+    fOutput->Add(fHistE3CStageCost);
+    fOutput->Add(fHistE3CCounters);
+    fOutput->Add(fHistE3CFamilyFills);
+    fOutput->Add(fHistE3CConeTracks);
+#endif
+    for (int m = 0; m < kE3CNModes; m++) {
+        fHistE3CEngineThreshold->SetBinContent(m + 1, fE3CDispatch.threshold[m] == INT_MAX ? -1 : fE3CDispatch.threshold[m]);
+        E3C_LOG_SETUP("E3C mode " << m << " sorted-pair engine from multiplicity " << fE3CDispatch.threshold[m]);
+    }
 
     
 
@@ -548,2538 +184,514 @@ if(fCout)cout<<"#####################---Declaring 3D Embedding Histograms E3C---
 // //________________________________________________________________________
 // //bkgindex = -1 for jet background particle, -2 for first thermal cone, -3 for second thermal cone, -4 for third thermal cone
 // //pt is true (gen) level jet pT, jetpt is the pT of the embedded subtracted jet
-void ComputeE3C(std::vector<fastjet::PseudoJet> particles, std::vector<fastjet::PseudoJet> particles2,std::vector<fastjet::PseudoJet> particles3, double jetpt, float pt, string typeSame, std::string type, bool ifMatchedJet)
+// //the particle blocks are built once per jet (E3CParticleBlock::Fill or FindMultipleThermalCones) and are already cut on corrTrkCut
+// //mode replaces the old typeSame/type strings: kE3CSameJet ("all","sameJet"), kE3CSameMB ("all","sameMB"), kE3CTwo ("two"), kE3CAllDiff
+void AliAnalysisTaskJetsEECpbpb::ComputeE3C(const E3CParticleBlock &particles, const E3CParticleBlock &particles2, const E3CParticleBlock &particles3, double jetpt, float pt, E3CMode mode, bool ifMatchedJet)
 {
-    if(fCout){cout<<particles.size()<<" and "<<particles2.size()<<" and "<<particles3.size()<<endl;}
-    int mult = particles.size();
-    int mult2 = particles2.size();
-    int mult3 = particles3.size();
-    
-    double w = 0;
-    double w_tru = 0;
-    double w_iij = 0;
-    double w_tru_iij = 0;
-    double w_e3c_3D = 0;
-    double w_e3c_tru_3D = 0;
-    double w_iij_3D = 0;
-    double w_tru_iij_3D = 0;
-    
-    double w_ijs = 0;
-    double w_ijs_tru = 0;
-    
-    double w_ijs_3D = 0;
-    double w_ijs_tru_3D = 0;
-    
-    double w_twosame = 0;
-    double w_twosame_tru = 0;
-    
-    double w_twosame_3D = 0;
-    double w_twosame_tru_3D = 0;
-    
-    double w_ijk = 0;
-    double w_ijk_tru = 0;
-    
-    double w_ijk_3D = 0;
-    double w_ijk_tru_3D = 0;
-    
-    
-    if(fCout){cout<<"!!!!!!!!!!after setting: "<<mult<<" and "<<mult2<<" and "<<mult3<<endl;}
-    if(fCout){cout<<"!!!!!!!!!!Setting are: typeSame "<<typeSame<<" and type "<<type<<endl;}
+    E3C_LOG_CALL(particles.Size() << " and " << particles2.Size() << " and " << particles3.Size() << " mode " << mode << " matched " << ifMatchedJet);
     
-    if(typeSame == "all"){
-        for (int i = 0; i < mult; i++)
-        {
-            if(particles.at(i).pt()<corrTrkCut) continue;
-            for (int j = i+1; j < mult; j++)
-            {
-                if(particles.at(j).pt()<corrTrkCut) continue;
-                
-                if(fCout){cout<<"in this loop"<<endl;}
-                
-                
-                w = (1./(jetpt*jetpt*jetpt))*(3*particles.at(i).pt()*particles.at(j).pt()*particles.at(j).pt());
-                w_tru = (1./(pt*pt*pt))*(3*particles.at(i).pt()*particles.at(j).pt()*particles.at(j).pt());
-                
-                w_iij = (1./(jetpt*jetpt*jetpt))*(3*particles.at(i).pt()*particles.at(i).pt()*particles.at(j).pt());
-                w_tru_iij = (1./(pt*pt*pt))*(3*particles.at(i).pt()*particles.at(i).pt()*particles.at(j).pt());
-                
-                
-                w_e3c_3D =  (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles.at(j).pt()*particles.at(j).pt());
-                w_e3c_tru_3D =  (1./(pt*pt*pt))*(particles.at(i).pt()*particles.at(j).pt()*particles.at(j).pt());
-                
-                w_iij_3D =  (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles.at(i).pt()*particles.at(j).pt());
-                w_iij_tru_3D =  (1./(pt*pt*pt))*(particles.at(i).pt()*particles.at(i).pt()*particles.at(j).pt());
-                
-                
-                
-                double dR = delR(particles.at(i), particles.at(j));
-                int i1 = particles.at(i).user_index();
-                int i2 = particles.at(j).user_index();
-                
-                if(fCout){cout<<"weights calculated"<<endl;}
-                
-                if(type =="sameJet")
-                {
-                    hJet_deltaR_MJ_e3c->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ_e3c->Fill(jetpt, pt, dR, w_iij);
-                    h3Jet_deltaR_MJ_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c->Fill(jetpt, dR, w_iij_3D);
-                    h3Jet_deltaR_MJ_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c->Fill(jetpt, dR, w_iij_3D);
-                    h3Jet_deltaR_MJ_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c->Fill(jetpt, dR, w_iij_3D);
-                    
-                    
-                    if(ifMatchedJet){
-                        if(fCout){cout<<"filling matched case"<<endl;}
-                        
-                        if(cfactor){
-                            hJet_deltaR_MJ_e3c_c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ_e3c_c_m->Fill(jetpt, pt, dR, w_iij);
-                            hJet_deltaR_MJ_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru_iij);
-                            
-                            h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                            
-                            h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                        }
-                        else{
-                            hJet_deltaR_MJ_e3c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ_e3c_m->Fill(jetpt, pt, dR, w_iij);
-                            hJet_deltaR_MJ_e3c_tru_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ_e3c_tru_m->Fill(jetpt, pt, dR, w_tru_iij);
-                            
-                            h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                            
-                            h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                        }
-                        else{
-                            
-                            if(cfactor){
-                                hJet_deltaR_MJ_e3c_c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ_e3c_c_um->Fill(jetpt, pt, dR, w_iij);
-                                
-                                h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                
-                            }
-                            else{
-                                hJet_deltaR_MJ_e3c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ_e3c_um->Fill(jetpt, pt, dR, w_iij);
-                                
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                            }
-                            
-                        }
-                        
-                        if ((i1 == 0) && (i2 == 0)) {
-                            hJet_deltaR_MJ0_e3c->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ0_e3c->Fill(jetpt, pt, dR, w_iij);
-                            
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c->Fill(jetpt, dR, w_iij_3D);
-                            
-                            if(ifMatchedJet){
-                                if(cfactor){
-                                    hJet_deltaR_MJ0_e3c_c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ0_e3c_c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ0_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ0_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    
-                                }
-                                else{
-                                    hJet_deltaR_MJ0_e3c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ0_e3c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ0_e3c_tru_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ0_e3c_tru_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    
-                                }
-                            }
-                            else{
-                                
-                                if(cfactor){
-                                    hJet_deltaR_MJ0_e3c_c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ0_e3c_c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                }
-                                else{
-                                    hJet_deltaR_MJ0_e3c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ0_e3c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                }
-                                
-                            }
-                        }//fake fake fake
-                        else if (i2 == 0) {
-                            hJet_deltaR_MJ1_e3c->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ2_e3c->Fill(jetpt, pt, dR, w_iij);
-                            
-                            
-                            h3Jet_deltaR_MJ1_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ1_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ1_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c->Fill(jetpt, dR, w_iij_3D);
-                            
-                            if(ifMatchedJet){
-                                if(cfactor){
-                                    hJet_deltaR_MJ1_e3c_c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ2_e3c_c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ1_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ2_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    
-                                }
-                                else{
-                                    hJet_deltaR_MJ1_e3c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ2_e3c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ1_e3c_tru_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ2_e3c_tru_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                }
-                            }
-                            else{
-                                
-                                if(cfactor){
-                                    hJet_deltaR_MJ1_e3c_c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ2_e3c_c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                }
-                                else{
-                                    hJet_deltaR_MJ1_e3c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ2_e3c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                }
-                                
-                            }
-                        }//real fake fake for ijj & real real fake for iij
-                        else if (i1 == 0) {
-                            hJet_deltaR_MJ2_e3c->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ1_e3c->Fill(jetpt, pt, dR, w_iij);
-                            
-                            
-                            h3Jet_deltaR_MJ2_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ2_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ2_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c->Fill(jetpt, dR, w_iij_3D);
-                            
-                            
-                            if(ifMatchedJet){
-                                if(cfactor){
-                                    hJet_deltaR_MJ2_e3c_c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ1_e3c_c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ2_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ1_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                }
-                                else{
-                                    hJet_deltaR_MJ2_e3c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ1_e3c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ2_e3c_tru_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ1_e3c_tru_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                }
-                            }
-                            else{
-                                if(cfactor){
-                                    hJet_deltaR_MJ2_e3c_c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ1_e3c_c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                }
-                                else{
-                                    hJet_deltaR_MJ2_e3c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ1_e3c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                }
-                            }
-                            
-                        }//real real fake
-                        else {
-                            hJet_deltaR_MJ3_e3c->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ3_e3c->Fill(jetpt, pt, dR, w_iij);
-                            
-                            h3Jet_deltaR_MJ3_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ3_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c->Fill(jetpt, dR, w_iij_3D);
-                            h3Jet_deltaR_MJ3_e3c->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c->Fill(jetpt, dR, w_iij_3D);
-                            
-                            
-                            if(ifMatchedJet){
-                                if(cfactor){
-                                    hJet_deltaR_MJ3_e3c_c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ3_e3c_c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ3_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ3_e3c_tru_c_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                                    
-                                }
-                                else{
-                                    hJet_deltaR_MJ3_e3c_m->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ3_e3c_m->Fill(jetpt, pt, dR, w_iij);
-                                    hJet_deltaR_MJ3_e3c_tru_m->Fill(jetpt, pt, dR, w_tru);hJet_deltaR_MJ3_e3c_tru_m->Fill(jetpt, pt, dR, w_tru_iij);
-                                    
-                                    h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, dR, w_iij_3D);
-                                    
-                                    h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                    h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                                }
-                            }
-                            else{
-                                if(cfactor){
-                                    hJet_deltaR_MJ3_e3c_c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ3_e3c_c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, dR, w_iij_3D);
-                                }
-                                else{
-                                    hJet_deltaR_MJ3_e3c_um->Fill(jetpt, pt, dR, w);hJet_deltaR_MJ3_e3c_um->Fill(jetpt, pt, dR, w_iij);
-                                    
-                                    h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                    h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, dR, w_e3c_3D);h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, dR, w_iij_3D);
-                                }
-                            }
-                            
-                        }//both are pythia
-                    }
-                    
-                }
-                
-                if(type=="sameMB"){
-                    
-                    if(fCout){cout<<"fill same MB"<<endl;}
-                    h_MB1MB1MB1->Fill(jetpt, pt, dR, w);
-                    h_MB1MB1MB1->Fill(jetpt, pt, dR, w_iij);
-                    
-                    h3_MB1MB1MB1->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1->Fill(jetpt, dR, w_iij_3D);
-                    h3_MB1MB1MB1->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1->Fill(jetpt, dR, w_iij_3D);
-                    h3_MB1MB1MB1->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1->Fill(jetpt, dR, w_iij_3D);
-                    
-                    
-                    if(ifMatchedJet){
-                        if(cfactor){
-                            h_MB1MB1MB1_c_m->Fill(jetpt, pt, dR, w);
-                            h_MB1MB1MB1_c_m->Fill(jetpt, pt, dR, w_iij);
-                            
-                            h_MB1MB1MB1_tru_c_m->Fill(jetpt, pt, dR, w_tru);
-                            h_MB1MB1MB1_tru_c_m->Fill(jetpt, pt, dR, w_tru_iij);
-                            
-                            h3_MB1MB1MB1_c_m->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_c_m->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_c_m->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_c_m->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_c_m->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_c_m->Fill(jetpt, dR, w_iij_3D);
-                            
-                            h3_MB1MB1MB1_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3_MB1MB1MB1_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3_MB1MB1MB1_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3_MB1MB1MB1_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3_MB1MB1MB1_tru_c_m->Fill(pt, dR, w_e3c_tru_3D);h3_MB1MB1MB1_tru_c_m->Fill(pt, dR, w_iij_tru_3D);
-                            
-                        }
-                        else{
-                            h_MB1MB1MB1_m->Fill(jetpt, pt, dR, w);
-                            h_MB1MB1MB1_m->Fill(jetpt, pt, dR, w_iij);
-                            
-                            h_MB1MB1MB1_tru_m->Fill(jetpt, pt, dR, w_tru);
-                            h_MB1MB1MB1_tru_m->Fill(jetpt, pt, dR, w_tru_iij);
-                            
-                            h3_MB1MB1MB1_m->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_m->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_m->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_m->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_m->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_m->Fill(jetpt, dR, w_iij_3D);
-                            
-                            h3_MB1MB1MB1_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3_MB1MB1MB1_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3_MB1MB1MB1_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3_MB1MB1MB1_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                            h3_MB1MB1MB1_tru_m->Fill(pt, dR, w_e3c_tru_3D);h3_MB1MB1MB1_tru_m->Fill(pt, dR, w_iij_tru_3D);
-                            
-                        }
-                        if(fCout){cout<<"matched same MB filled"<<endl;}
-                    }
-                    else{
-                        if(cfactor){
-                            h_MB1MB1MB1_c_um->Fill(jetpt, pt, dR, w);
-                            h_MB1MB1MB1_c_um->Fill(jetpt, pt, dR, w_iij);
-                            
-                            h3_MB1MB1MB1_c_um->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_c_um->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_c_um->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_c_um->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_c_um->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_c_um->Fill(jetpt, dR, w_iij_3D);
-                            
-                        }
-                        else{
-                            h_MB1MB1MB1_um->Fill(jetpt, pt, dR, w);
-                            h_MB1MB1MB1_um->Fill(jetpt, pt, dR, w_iij);
-                            
-                            h3_MB1MB1MB1_um->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_um->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_um->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_um->Fill(jetpt, dR, w_iij_3D);
-                            h3_MB1MB1MB1_um->Fill(jetpt, dR, w_e3c_3D);h3_MB1MB1MB1_um->Fill(jetpt, dR, w_iij_3D);
-                            
-                        }
-                        
-                    }
-                    
-                    if(fCout){cout<<"same MB filled"<<endl;}
-                }
-                for (int s = j+1; s < mult; s++)
-                {
-                    
-                    if(particles.at(s).pt()<corrTrkCut) continue;
-                    
-                    if(fCout){cout<<"s=j+1 loop"<<endl;}
-                    
-                    
-                    w_ijs = (1./(jetpt*jetpt*jetpt))*(6*particles.at(i).pt()*particles.at(j).pt()*particles.at(s).pt());
-                    w_ijs_tru = (1./(pt*pt*pt))*(6*particles.at(i).pt()*particles.at(j).pt()*particles.at(s).pt());
-                    
-                    w_ijs_3D = (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles.at(j).pt()*particles.at(s).pt());
-                    w_ijs_tru_3D = (1./(pt*pt*pt))*(particles.at(i).pt()*particles.at(j).pt()*particles.at(s).pt());
-                    
-                    
-                    double dR_ij = delR(particles.at(i), particles.at(j));
-                    double dR_js = delR(particles.at(j), particles.at(s));
-                    double dR_is = delR(particles.at(s), particles.at(i));
-                    
-                    double R_L = -1;
-                    if(dR_ij>dR_js && dR_ij>dR_is){R_L = dR_ij;}
-                    else if(dR_js>dR_ij && dR_js>dR_is){R_L = dR_js;}
-                    else{R_L = dR_is;}
-                    
-                    int i1 = particles.at(i).user_index();
-                    int i2 = particles.at(j).user_index();
-                    int i3 = particles.at(s).user_index();
-                    
-                    if(fCout){cout<<"ijs loop RL computed"<<endl;}
-                    
-                    if(type=="sameJet"){
-                        
-                        if(fCout){cout<<"fill same jet ijs"<<endl;}
-                        
-                        hJet_deltaR_MJ_e3c->Fill(jetpt, pt, R_L, w_ijs);
-                        
-                        h3Jet_deltaR_MJ_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                        h3Jet_deltaR_MJ_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                        h3Jet_deltaR_MJ_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                        h3Jet_deltaR_MJ_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                        h3Jet_deltaR_MJ_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                        h3Jet_deltaR_MJ_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                hJet_deltaR_MJ_e3c_c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                hJet_deltaR_MJ_e3c_tru_c_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                
-                                h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                
-                                h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                
-                            }
-                            else{
-                                hJet_deltaR_MJ_e3c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                hJet_deltaR_MJ_e3c_tru_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                
-                                h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                
-                                h3Jet_deltaR_MJ_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                h3Jet_deltaR_MJ_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                hJet_deltaR_MJ_e3c_c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                
-                                h3Jet_deltaR_MJ_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                
-                            }
-                            else{
-                                hJet_deltaR_MJ_e3c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                            }
-                        }
-                        
-                        if ((i1 == 0) && (i2 == 0) && (i3 ==0)){
-                            hJet_deltaR_MJ0_e3c->Fill(jetpt, pt, R_L, w_ijs);
-                            
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                            h3Jet_deltaR_MJ0_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                            
-                            if(ifMatchedJet){
-                                if(cfactor){
-                                    hJet_deltaR_MJ0_e3c_c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                    hJet_deltaR_MJ0_e3c_tru_c_m->Fill(jetpt, pt, R_L, w_ijs_tru)
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                }
-                                else{
-                                    hJet_deltaR_MJ0_e3c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                    hJet_deltaR_MJ0_e3c_tru_m->Fill(jetpt, pt, R_L, w_ijs_tru)
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake fake
-                                    
-                                }
-                            }
-                            else{
-                                if(cfactor){
-                                    hJet_deltaR_MJ0_e3c_c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                }
-                                else{
-                                    hJet_deltaR_MJ0_e3c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                    
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    h3Jet_deltaR_MJ0_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake fake
-                                    
-                                }
-                            }
-                            else if (((i1 == 0) && (i2 == 0) && (i3 != 0)) ||((i1 == 0) && (i2 != 0) && (i3 == 0)) ||((i1 != 0) && (i2 == 0) && (i3 == 0))){
-                                
-                                hJet_deltaR_MJ1_e3c->Fill(jetpt, pt, R_L, w_ijs);
-                                
-                                h3Jet_deltaR_MJ1_e3c->Fill(jetpt, R_L, w_ijs_3D);//fake fake REAL
-                                h3Jet_deltaR_MJ1_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ1_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ1_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ1_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ1_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                
-                                if(ifMatchedJet){
-                                    if(cfactor){
-                                        hJet_deltaR_MJ1_e3c_c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                        hJet_deltaR_MJ1_e3c_tru_c_m->Fill(jetpt, pt, R_L, w_ijs_tru)
-                                        
-                                        h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake REAL
-                                        h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                        h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake REAL
-                                        h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        
-                                    }
-                                    else{
-                                        
-                                        hJet_deltaR_MJ1_e3c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                        hJet_deltaR_MJ1_e3c_tru_m->Fill(jetpt, pt, R_L, w_ijs_tru)
-                                        
-                                        h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, R_L, w_ijs_3D);//fake fake REAL
-                                        h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                        h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);//fake fake REAL
-                                        h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ1_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        
-                                    }
-                                }
-                                else{
-                                    if(cfactor){
-                                        hJet_deltaR_MJ1_e3c_c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                        
-                                        h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake REAL
-                                        h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                    }
-                                    else{
-                                        hJet_deltaR_MJ1_e3c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                        
-                                        h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, R_L, w_ijs_3D);//fake fake REAL
-                                        h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ1_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                    }
-                                    
-                                    
-                                }
-                            }
-                            else if (((i1 == 0) && (i2 != 0) && (i3 != 0)) ||((i1 != 0) && (i2 != 0) && (i3 == 0)) ||((i1 != 0) && (i2 == 0) && (i3 != 0)))
-                            {
-                                hJet_deltaR_MJ2_e3c->Fill(jetpt, pt, R_L, w_ijs);
-                                
-                                h3Jet_deltaR_MJ2_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ2_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ2_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ2_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ2_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ2_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                
-                                if(ifMatchedJet){
-                                    if(cfactor){
-                                        hJet_deltaR_MJ2_e3c_c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                        hJet_deltaR_MJ2_e3c_tru_c_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                        
-                                        h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                        h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        
-                                    }
-                                    else{
-                                        hJet_deltaR_MJ2_e3c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                        hJet_deltaR_MJ2_e3c_tru_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                        
-                                        h3Jet_deltaR_MJ2_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                        h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ2_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        
-                                    }
-                                }
-                                else{
-                                    if(cfactor){
-                                        hJet_deltaR_MJ2_e3c_c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                        
-                                        h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    }
-                                    else{
-                                        hJet_deltaR_MJ2_e3c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                        
-                                        h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ2_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    }
-                                }
-                                
-                            }
-                            else{
-                                hJet_deltaR_MJ3_e3c->Fill(jetpt, pt, R_L, w_ijs);//real real real
-                                
-                                
-                                h3Jet_deltaR_MJ3_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ3_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ3_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ3_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ3_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                h3Jet_deltaR_MJ3_e3c->Fill(jetpt, R_L, w_ijs_3D);
-                                
-                                if(ifMatchedJet){
-                                    
-                                    if(cfactor){
-                                        
-                                        hJet_deltaR_MJ3_e3c_c_m->Fill(jetpt, pt, R_L, w_ijs);//real real real
-                                        hJet_deltaR_MJ3_e3c_tru_c_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                        
-                                        h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                        h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        
-                                    }
-                                    else{
-                                        hJet_deltaR_MJ3_e3c_m->Fill(jetpt, pt, R_L, w_ijs);//real real real
-                                        hJet_deltaR_MJ3_e3c_tru_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                        
-                                        h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                        h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        h3Jet_deltaR_MJ3_e3c_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                        
-                                    }
-                                }
-                                else{
-                                    if(cfactor){
-                                        hJet_deltaR_MJ3_e3c_c_um->Fill(jetpt, pt, R_L, w_ijs);//real real real
-                                        
-                                        h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        
-                                    }
-                                    else{
-                                        hJet_deltaR_MJ3_e3c_um->Fill(jetpt, pt, R_L, w_ijs);//real real real
-                                        
-                                        h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                        h3Jet_deltaR_MJ3_e3c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    }
-                                }
-                            }
-                        }
-                        
-                        if(type=="sameMB"){
-                            if(fCout){cout<<"same MB ijs loop"<<endl;}
-                            h_MB1MB1MB1->Fill(jetpt, pt, R_L, w_ijs);
-                            
-                            h3_MB1MB1MB1->Fill(jetpt, R_L, w_ijs_3D);
-                            h3_MB1MB1MB1->Fill(jetpt, R_L, w_ijs_3D);
-                            h3_MB1MB1MB1->Fill(jetpt, R_L, w_ijs_3D);
-                            h3_MB1MB1MB1->Fill(jetpt, R_L, w_ijs_3D);
-                            h3_MB1MB1MB1->Fill(jetpt, R_L, w_ijs_3D);
-                            h3_MB1MB1MB1->Fill(jetpt, R_L, w_ijs_3D);
-                            
-                            if(ifMatchedJet){
-                                if(cfactor){
-                                    h_MB1MB1MB1_c_m->Fill(jetpt, pt, R_L, w_ijs);
-                                    h_MB1MB1MB1_tru_c_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                    
-                                    h3_MB1MB1MB1_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    
-                                    h3_MB1MB1MB1_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_c_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    
-                                }
-                                else{
-                                    h_MB1MB1MB1_m->Fill(jetpt, pt, R_L, w_ijs);
-                                    h_MB1MB1MB1_tru_m->Fill(jetpt, pt, R_L, w_ijs_tru);
-                                    
-                                    h3_MB1MB1MB1_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_m->Fill(jetpt, R_L, w_ijs_3D);
-                                    
-                                    h3_MB1MB1MB1_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                    h3_MB1MB1MB1_tru_m->Fill(pt, R_L, w_ijs_tru_3D);
-                                }
-                            }
-                            else{
-                                if(cfactor){
-                                    h_MB1MB1MB1_c_um->Fill(jetpt, pt, R_L, w_ijs);
-                                    
-                                    h3_MB1MB1MB1_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_c_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    
-                                }
-                                else{
-                                    h_MB1MB1MB1_um->Fill(jetpt, pt, R_L, w_ijs);
-                                    
-                                    h3_MB1MB1MB1_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    h3_MB1MB1MB1_um->Fill(jetpt, R_L, w_ijs_3D);
-                                    
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    //(mode, matched, cfactor) selects one template instantiation per jet; which histograms a
+    //triplet goes to comes from the origin-code lookup table (see AliAnalysisTaskJetsEECpbpbE3Ccode.h)
+    //nested cones: every radius in one triplet-engine enumeration, after the queued calls so the
+    //banks see the serial order
+    if (fE3CNRadii > 1 && E3CNested(mode, particles, particles2, particles3)) {
+        if (fE3CParallel) RunE3CJobs();
+        const auto start = std::chrono::steady_clock::now();
+        E3CComputeNested(mode, ifMatchedJet, cfactor, particles, particles2, particles3, fE3CNRadii, jetpt, pt, fE3CWork, fE3CHists, fE3CRadiusBank);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        fHistE3CEngineCalls->Fill(mode, kE3CEngineTriplet);
+        fHistE3CEngineTime->Fill(mode, kE3CEngineTriplet, us);
+        E3C_INSTR(RecordE3CStage(kE3CStageCompute + mode, E3CDispatcher::Multiplicity(mode, particles.Size(), particles2.Size(), particles3.Size()), 1e-6 * us);)
+        fE3CTrace.Push(fE3CEvents - 1, fE3CJet, kE3CStageCompute + mode, particles.Size(), particles2.Size(), particles3.Size(), us, jetpt);
+        return;
     }
-    else if (typeSame == "two"){
-        //particles2 and particles3 is the same list
-        
-        for (int i = 0; i < mult; i++)
-        {
-            if(particles.at(i).pt()<corrTrkCut) continue;
-            int i1 = particles.at(i).user_index();
-            
-            for (int  j = 0; j < mult2; j++)
-            {
-                
-                if(particles2.at(j).pt()<corrTrkCut) continue;
-                
-                int i2 = particles2.at(j).user_index();
-                
-                w_twosame = (1./(jetpt*jetpt*jetpt))*(3*particles.at(i).pt()*particles2.at(j).pt()*particles2.at(j).pt());
-                w_twosame_tru = (1./(pt*pt*pt))*(particles.at(i).pt()*particles2.at(j).pt()*particles2.at(j).pt());
-                
-                w_twosame_3D = (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles2.at(j).pt()*particles2.at(j).pt());
-                w_twosame_tru_3D = (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles2.at(j).pt()*particles2.at(j).pt());
-                
-                double R_L = delR(particles.at(i), particles2.at(j));
-                
-                if(fCout){cout<<" about to fill histograms in TWO SAME"<<endl;}
-                if(i1==-2 && (i2 == 1 || i2 == 0)) {
-                    
-                    if(fCout){cout<<" filled jjmb TWO SAME"<<endl;}
-                    
-                    h_JJMB->Fill(jetpt, pt, R_L,w_twosame);
-                    
-                    h3_JJMB->Fill(jetpt, pt, R_L,w_twosame_3D);
-                    h3_JJMB->Fill(jetpt, pt, R_L,w_twosame_3D);
-                    h3_JJMB->Fill(jetpt, pt, R_L,w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        
-                        if(cfactor){
-                            h_JJMB_c_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_JJMB_tru_c_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_JJMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JJMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JJMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_JJMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JJMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JJMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            
-                            
-                        }
-                        else{
-                            h_JJMB_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_JJMB_tru_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_JJMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JJMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JJMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_JJMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JJMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JJMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                        
-                    }
-                    else{
-                        if(cfactor){
-                            h_JJMB_c_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_JJMB_c_um->Fill(jetpt, pt, R_L,w_twosame_3D);
-                            h3_JJMB_c_um->Fill(jetpt, pt, R_L,w_twosame_3D);
-                            h3_JJMB_c_um->Fill(jetpt, pt, R_L,w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_JJMB_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_JJMB_um->Fill(jetpt, pt, R_L,w_twosame_3D);
-                            h3_JJMB_um->Fill(jetpt, pt, R_L,w_twosame_3D);
-                            h3_JJMB_um->Fill(jetpt, pt, R_L,w_twosame_3D);
-                            
-                        }
-                    }
-                }
-                if(i1==-2 && i2 == 0 && i2 == 0){
-                    if(fCout){cout<<" filled bbmb TWO SAME"<<endl;}
-                    
-                    h_BBMB->Fill(jetpt, pt, R_L,w_twosame);
-                    
-                    h3_BBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_BBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_BBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        if(cfactor){
-                            h_BBMB_c_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_BBMB_tru_c_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_BBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_BBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_BBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_BBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            
-                        }
-                        else{
-                            h_BBMB_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_BBMB_tru_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_BBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_BBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_BBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_BBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_BBMB_c_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_BBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_BBMB_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_BBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                        }
-                    }
-                }
-                if(i1==-2 && i2 == 1 && i2 == 1){
-                    
-                    if(fCout){cout<<" filled ssmb TWO SAME"<<endl;}
-                    
-                    h_SSMB->Fill(jetpt, pt, R_L,w_twosame);
-                    
-                    h3_SSMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_SSMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_SSMB->Fill(jetpt, R_L,w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        if(cfactor){
-                            h_SSMB_c_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_SSMB_tru_c_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_SSMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_SSMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SSMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SSMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                        else{
-                            h_SSMB_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_SSMB_tru_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_SSMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_SSMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SSMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SSMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_SSMB_c_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_SSMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_SSMB_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_SSMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SSMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                        }
-                    }
-                }
-                
-                if((i1== 0 || i1 == 1) && (i2 == -2)){
-                    
-                    if(fCout){cout<<" filled jmbmb TWO SAME"<<endl;}
-                    
-                    h_JMBMB->Fill(jetpt, pt, R_L,w_twosame);
-                    
-                    h3_JMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_JMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_JMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        if(cfactor){
-                            h_JMBMB_c_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_JMBMB_tru_c_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_JMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_JMBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JMBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JMBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            
-                        }
-                        else{
-                            h_JMBMB_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_JMBMB_tru_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_JMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_JMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_JMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_JMBMB_c_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_JMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                        }
-                        else{
-                            h_JMBMB_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_JMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_JMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                        }
-                    }
-                }
-                if((i1== 0)  && (i2 == -2) && (i2==-2)){
-                    
-                    if(fCout){cout<<" filled bmbmb TWO SAME"<<endl;}
-                    
-                    h_BMBMB->Fill(jetpt, pt, R_L,w_twosame);
-                    
-                    h3_BMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_BMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_BMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        
-                        if(cfactor){
-                            h_BMBMB_c_m->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_BMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_BMBMB_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_BMBMB_tru_m->Fill(jetpt, pt, R_L,w_twosame_yri);
-                            
-                            h3_BMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_BMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_BMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_BMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_BMBMB_c_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_BMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                        }
-                        else{
-                            h_BMBMB_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_BMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_BMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                        }
-                    }
-                }
-                if((i1 == 1) && (i2 == -2) && (i2==-2)){
-                    
-                    if(fCout){cout<<" filled smbmb TWO SAME"<<endl;}
-                    
-                    h_SMBMB->Fill(jetpt, pt, R_L,w_twosame);
-                    
-                    h3_SMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_SMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    h3_SMBMB->Fill(jetpt, R_L,w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        if(cfactor){
-                            h_SMBMB_c_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_SMBMB_tru_c_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_SMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_c_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_SMBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SMBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SMBMB_tru_c_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                        else{
-                            h_SMBMB_m->Fill(jetpt, pt, R_L,w_twosame);
-                            h_SMBMB_tru_m->Fill(jetpt, pt, R_L,w_twosame_tru);
-                            
-                            h3_SMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_m->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                            h3_SMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                            h3_SMBMB_tru_m->Fill(pt, R_L,w_twosame_tru_3D);
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_SMBMB_c_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_SMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_c_um->Fill(jetpt, R_L,w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_SMBMB_um->Fill(jetpt, pt, R_L,w_twosame);
-                            
-                            h3_SMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                            h3_SMBMB_um->Fill(jetpt, R_L,w_twosame_3D);
-                        }
-                    }
-                }
-                
-                if(i1 == -3 && i2 == -2){
-                    
-                    if(fCout){cout<<" filled mb1mb1mb2 TWO SAME"<<endl;}
-                    
-                    h_MB1MB1MB2->Fill(jetpt, pt, R_L, w_twosame);
-                    
-                    h3_MB1MB1MB2->Fill(jetpt, R_L, w_twosame_3D);
-                    h3_MB1MB1MB2->Fill(jetpt, R_L, w_twosame_3D);
-                    h3_MB1MB1MB2->Fill(jetpt, R_L, w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        if(cfactor){
-                            h_MB1MB1MB2_c_m->Fill(jetpt, pt, R_L, w_twosame);
-                            h_MB1MB1MB2_tru_c_m->Fill(jetpt, pt, R_L, w_twosame_tru);
-                            
-                            h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_twosame_3D);
-                            
-                            h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_twosame_tru_3D);
-                            
-                        }
-                        else{
-                            h_MB1MB1MB2_m->Fill(jetpt, pt, R_L, w_twosame);
-                            h_MB1MB1MB2_tru_m->Fill(jetpt, pt, R_L, w_twosame_tru);
-                            
-                            h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_twosame_3D);
-                            
-                            h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_twosame_tru_3D);
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_MB1MB1MB2_c_um->Fill(jetpt, pt, R_L, w_twosame);
-                            
-                            h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_MB1MB1MB2_um->Fill(jetpt, pt, R_L, w_twosame);
-                            
-                            h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_twosame_3D);
-                        }
-                    }
-                }
-                if(i1 == -2 && i2 == -3){
-                    
-                    if(fCout){cout<<" filled mb1mb2mb2 TWO SAME"<<endl;}
-                    
-                    h_MB1MB2MB2->Fill(jetpt, pt, R_L, w_twosame);
-                    
-                    h3_MB1MB2MB2->Fill(jetpt, R_L, w_twosame_3D);
-                    h3_MB1MB2MB2->Fill(jetpt, R_L, w_twosame_3D);
-                    h3_MB1MB2MB2->Fill(jetpt, R_L, w_twosame_3D);
-                    
-                    if(ifMatchedJet){
-                        
-                        if(cfactor){
-                            h_MB1MB2MB2_c_m->Fill(jetpt, pt, R_L, w_twosame);
-                            h_MB1MB2MB2_tru_c_m->Fill(jetpt, pt, R_L, w_twosame_tru);
-                            
-                            h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_twosame_3D);
-                            
-                            h3_MB1MB2MB2_tru_c_m->Fill(jetpt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB2MB2_tru_c_m->Fill(jetpt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB2MB2_tru_c_m->Fill(jetpt, R_L, w_twosame_tru_3D);
-                        }
-                        else{
-                            h_MB1MB2MB2_m->Fill(jetpt, pt, R_L, w_twosame);
-                            h_MB1MB2MB2_tru_m->Fill(jetpt, pt, R_L, w_twosame_tru);
-                            
-                            h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_twosame_3D);
-                            
-                            h3_MB1MB2MB2_tru_m->Fill(jetpt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB2MB2_tru_m->Fill(jetpt, R_L, w_twosame_tru_3D);
-                            h3_MB1MB2MB2_tru_m->Fill(jetpt, R_L, w_twosame_tru_3D);
-                        }
-                    }
-                    else{
-                        if(cfactor){
-                            h_MB1MB2MB2_c_um->Fill(jetpt, pt, R_L, w_twosame);
-                            
-                            h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_twosame_3D);
-                            
-                        }
-                        else{
-                            h_MB1MB2MB2_um->Fill(jetpt, pt, R_L, w_twosame);
-                            
-                            h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_twosame_3D);
-                            h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_twosame_3D);
-                        }
-                    }
-                }
-                
-                if(fCout){cout<<" filled j loop in TWO SAME"<<endl;}
-                
-                for (int k = j+1; k < mult2; k++)
-                {
-                    if(particles2.at(k).pt()<corrTrkCut) continue;
-                    int i3 = particles2.at(k).user_index();
-                    
-                    
-                    w_ijk = (1./(jetpt*jetpt*jetpt))*(6*particles.at(i).pt()*particles2.at(j).pt()*particles2.at(k).pt());
-                    w_ijk_tru = (1./(pt*pt*pt))*(6*particles.at(i).pt()*particles2.at(j).pt()*particles2.at(k).pt());
-                    
-                    w_ijk_3D = (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles2.at(j).pt()*particles2.at(k).pt());
-                    w_ijk_tru_3D = (1./(pt*pt*pt))*(particles.at(i).pt()*particles2.at(j).pt()*particles2.at(k).pt());
-                    
-                    
-                    
-                    double dR_ij = delR(particles.at(i), particles2.at(j));
-                    double dR_js = delR(particles2.at(j), particles2.at(k));
-                    double dR_is = delR(particles2.at(k), particles.at(i));
-                    
-                    double R_L = -1;
-                    if(dR_ij>dR_js && dR_ij>dR_is){R_L = dR_ij;}
-                    else if(dR_js>dR_ij && dR_js>dR_is){R_L = dR_js;}
-                    else{R_L = dR_is;}
-                    
-                    
-                    if(i1==-2 && (i2 == 1 || i2 == 0) && (i3 == 1 || i3 == 0)) {
-                        
-                        if(fCout){cout<<" filled jjmb two same "<<endl;}
-                        h_JJMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_JJMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JJMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JJMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JJMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JJMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JJMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_JJMB_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_JJMB_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_JJMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_JJMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_JJMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_JJMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_JJMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_JJMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_JJMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_JJMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_JJMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                            else{
-                                h_JJMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_JJMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JJMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                    if(i1==-2 && i2 == 0 && i3 == 0){
-                        if(fCout){cout<<" filled bbmb two same "<<endl;}
-                        
-                        h_BBMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_BBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_BBMB_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_BBMB_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_BBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_BBMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_c_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_BBMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_BBMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_BBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_BBMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                                h3_BBMB_tru_m->Fill(jetpt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_BBMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_BBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                            else{
-                                h_BBMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_BBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                            }
-                        }
-                    }
-                    if(i1==-2 && i2 == 1 && i3 == 1){
-                        
-                        if(fCout){cout<<" filled ssmb two same "<<endl;}
-                        
-                        h_SSMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_SSMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SSMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SSMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SSMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SSMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SSMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_SSMB_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_SSMB_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_SSMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_SSMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_SSMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_SSMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_SSMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_SSMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SSMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_SSMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SSMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                            }
-                            else{
-                                h_SSMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SSMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SSMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                    if(i1==-2 && ((i2 == 0 && i3 == 1)||(i2 == 1 && i3 == 0))) {
-                        
-                        if(fCout){cout<<" filled sbmb two same "<<endl;}
-                        h_SBMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_SBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            
-                            h_SBMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                            h_SBMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                            
-                            h3_SBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                            h3_SBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                            h3_SBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                            h3_SBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                            h3_SBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                            h3_SBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                            
-                            h3_SBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            h3_SBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            h3_SBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            h3_SBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            h3_SBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            h3_SBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            
-                        }
-                        else{
-                            if(cfactor){
-                                h_SBMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                            else{
-                                h_SBMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                            }
-                        }
-                    }
-                    if((i1== 0 || i1 == 1) && (i2 == -2) && (i3==-2)) {
-                        
-                        if(fCout){cout<<" filled jmbmb two same "<<endl;}
-                        h_JMBMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_JMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_JMBMB_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_JMBMB_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_JMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_JMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_JMBMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_JMBMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_JMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_JMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_JMBMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_JMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                            else{
-                                h_JMBMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_JMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                    if((i1== 0)  && (i2 == -2) && (i3== -2)){
-                        
-                        if(fCout){cout<<" filled bmbmb two same "<<endl;}
-                        h_BMBMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_BMBMB_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_BMBMB_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_BMBMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_BMBMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_BMBMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                            }
-                            else{
-                                h_BMBMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                            
-                        }
-                    }
-                    if((i1 == 1) && (i2 == -2) && (i3==-2)){
-                        
-                        if(fCout){cout<<" filled smbmb two same "<<endl;}
-                        
-                        h_SMBMB->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_SMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMBMB->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_SMBMB_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_SMBMB_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_SMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_SMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_SMBMB_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_SMBMB_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_SMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_SMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMBMB_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_SMBMB_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                            }
-                            else{
-                                h_SMBMB_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMBMB_um->Fill(jetpt, R_L,w_ijk_3D);
-                            }
-                        }
-                    }
-                    
-                    if(i1 == -3 && i2 == -2 && i3 == -2){
-                        
-                        if(fCout){cout<<" filled mb1mb1mb2 two same "<<endl;}
-                        
-                        h_MB1MB1MB2->Fill(jetpt, pt, R_L, w_ijk);
-                        
-                        h3_MB1MB1MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB1MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB1MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB1MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB1MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB1MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_MB1MB1MB2_c_m->Fill(jetpt, pt, R_L, w_ijk);
-                                h_MB1MB1MB2_tru_c_m->Fill(jetpt, pt, R_L, w_ijk_tru);
-                                
-                                h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                                h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                            }
-                            else{
-                                h_MB1MB1MB2_m->Fill(jetpt, pt, R_L, w_ijk);
-                                h_MB1MB1MB2_tru_m->Fill(jetpt, pt, R_L, w_ijk_tru);
-                                
-                                h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                                h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB1MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_MB1MB1MB2_c_um->Fill(jetpt, pt, R_L, w_ijk);
-                                
-                                h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                            }
-                            else{
-                                h_MB1MB1MB2_um->Fill(jetpt, pt, R_L, w_ijk);
-                                
-                                h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB1MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                            }
-                            
-                        }
-                    }
-                    if(i1 == -2 && i2 == -3 && i3 == -3){
-                        if(fCout){cout<<" filled mb1mb2mb2 two same "<<endl;}
-                        
-                        h_MB1MB2MB2->Fill(jetpt, pt, R_L, w_ijk);
-                        
-                        h3_MB1MB2MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB2MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB2MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB2MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB2MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        h3_MB1MB2MB2->Fill(jetpt, R_L, w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_MB1MB2MB2_c_m->Fill(jetpt, pt, R_L, w_ijk);
-                                h_MB1MB2MB2_tru_c_m->Fill(jetpt, pt, R_L, w_ijk_tru);
-                                
-                                h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_m->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                                h3_MB1MB2MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_c_m->Fill(pt, R_L, w_ijk_tru_3D);
-                            }
-                            else{
-                                h_MB1MB2MB2_m->Fill(jetpt, pt, R_L, w_ijk);
-                                h_MB1MB2MB2_tru_m->Fill(jetpt, pt, R_L, w_ijk_tru);
-                                
-                                h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_m->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                                h3_MB1MB2MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                h3_MB1MB2MB2_tru_m->Fill(pt, R_L, w_ijk_tru_3D);
-                                
-                            }
-                            
-                        }
-                        else{
-                            if(cfactor){
-                                h_MB1MB2MB2_c_um->Fill(jetpt, pt, R_L, w_ijk);
-                                
-                                h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_c_um->Fill(jetpt, R_L, w_ijk_3D);
-                            }
-                            else{
-                                h_MB1MB2MB2_um->Fill(jetpt, pt, R_L, w_ijk);
-                                
-                                h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                h3_MB1MB2MB2_um->Fill(jetpt, R_L, w_ijk_3D);
-                                
-                            }
-                            
+    //engine per call from the multiplicities and the booked histograms, unless fixed by SetE3CEngine
+    const E3CEngine engine = fE3CDispatch.Choose(mode, ifMatchedJet, cfactor, particles.Size(), particles2.Size(), particles3.Size());
+    if (fE3CParallel) {
+        //queued; computed and added to fE3CHists by RunE3CJobs at the end of the event
+        fE3CParallel->Submit(mode, engine, ifMatchedJet, cfactor, particles, particles2, particles3, jetpt, pt);
+        fE3CParallel->jobs[fE3CParallel->nJobs - 1].jet = fE3CJet;
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    //MB-only calls on cached cones reuse the sums of an earlier jet with the same cones
+    if (fE3CConeCache.enabled && E3CConeCache::ConesOnly(mode, particles, particles2, particles3) && !fE3CDispatch.has3D[mode][ifMatchedJet][cfactor])
+        fE3CConeCache.Compute(mode, engine, ifMatchedJet, cfactor, particles, particles2, particles3, jetpt, pt, fE3CWork, fE3CHists);
+    else
+        E3CCompute(mode, engine, ifMatchedJet, cfactor, particles, particles2, particles3, jetpt, pt, fE3CWork, fE3CHists);
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    fHistE3CEngineCalls->Fill(mode, engine);
+    fHistE3CEngineTime->Fill(mode, engine, us);
+    E3C_INSTR(RecordE3CStage(kE3CStageCompute + mode, E3CDispatcher::Multiplicity(mode, particles.Size(), particles2.Size(), particles3.Size()), 1e-6 * us);)
+    fE3CTrace.Push(fE3CEvents - 1, fE3CJet, kE3CStageCompute + mode, particles.Size(), particles2.Size(), particles3.Size(), us, jetpt);
+}
+// //______________________________________________________________________
+// //Projected N-point correlators of one list (AddE3CENCFamily): every order up to the highest booked
+// //one in a single walk, into hE<n>C_<label>. For the mixed jet-cone terms pass the jet with its
+// //cones appended (E3CParticleBlock::Append): the J/MB labels pick the terms by origin code
+void AliAnalysisTaskJetsEECpbpb::ComputeENC(const E3CParticleBlock &particles, double jetpt, float pt, bool ifMatchedJet)
+{
+    if (!fE3CENC.order) return;
+    E3C_STAGE(kE3CStageENC, particles.Size());
+    E3CComputeENC(fE3CENC, ifMatchedJet, cfactor, particles, jetpt, pt, fE3CWork, fE3CENCBank);
+}
+// //______________________________________________________________________
+// //Parallel mode: runs the ComputeE3C calls queued during the event on the thread pool and adds
+// //them to fE3CHists in the order they were made, so the output does not depend on the thread
+// //count. Called at the end of UserExec, after the jet loop, and from FinishTaskOutput
+void AliAnalysisTaskJetsEECpbpb::RunE3CJobs()
+{
+    if (!fE3CParallel) return;
+    fE3CParallel->Run(fE3CHists, [this](const E3CParallel::Job &job) {
+        fHistE3CEngineCalls->Fill(job.mode, job.engine);
+        fHistE3CEngineTime->Fill(job.mode, job.engine, 1e6 * job.seconds);
+        E3C_INSTR(RecordE3CStage(kE3CStageCompute + job.mode, E3CDispatcher::Multiplicity(job.mode, job.a.Size(), job.b.Size(), job.c.Size()), job.seconds);)
+        fE3CTrace.Push(fE3CEvents - 1, job.jet, kE3CStageCompute + job.mode, job.a.Size(), job.b.Size(), job.c.Size(), 1e6 * job.seconds, job.jetpt);
+    });
+}
+#if E3C_INSTRUMENT
+// //______________________________________________________________________
+// //Instrumentation (E3C_INSTRUMENT): one call of stage, handling multiplicity particles, took seconds
+void AliAnalysisTaskJetsEECpbpb::RecordE3CStage(int stage, int multiplicity, double seconds)
+{
+    fHistE3CStageTime->Fill(stage, 1e6 * seconds);
+    fHistE3CStageCalls->Fill(stage);
+    fHistE3CStageCost->Fill(multiplicity, stage, 1e6 * seconds);
+}
+#endif
+// //______________________________________________________________________
+// //Worker side, before the output is written: the E3C bank becomes standard TH3D in fOutput,
+// //so merging and the downstream macros see the same objects as before. Each moments family
+// //gives a TH2D hw_* (sum of weights, Sumw2 = sum of squared weights) and hw_*_n (orderings)
+void AliAnalysisTaskJetsEECpbpb::FinishTaskOutput()
+{
+    RunE3CJobs();
+    if (fE3CEvents) fHistE3CAllocations->Fill(fE3CBlocks.Reset());
+    if (fE3CConeCache.enabled) {
+        const double counts[4] = {fE3CConeCache.coneLookups, fE3CConeCache.coneHits, fE3CConeCache.termLookups, fE3CConeCache.termHits};
+        for (int b = 0; b < 4; b++) fHistE3CConeCache->SetBinContent(b + 1, counts[b]);
+    }
+    for (int r = 0; r < fE3CNRadii; r++) {
+        //the extra radii of the nested cones append the radius to the names, e.g. h3_MB1MB1MB1_R030
+        E3CHistBank &hists = *fE3CRadiusBank[r];
+        const std::string suffix = r == fE3CMainRadius ? "" : Form("_R%03d", TMath::Nint(100 * fE3CRadii[r]));
+        for (int k = 0; k < kE3CNKinds; k++) {
+            for (int c = 0; c < kE3CNCategories; c++) {
+                const E3CAxis *ax = hists.axis[k][c];
+                for (int v = 0; v < kE3CNVariants; v++) {
+                    if (!hists.Booked(k, c, v)) continue;
+                    const std::string name = E3CHistName(k, c, v) + suffix;
+                    const bool single = hists.Single(k, c);
+                    if (hists.validate && single) {
+                        //one bin for all radii of a family: the largest deviation among them
+                        const double dev = hists.MaxRelDeviation(k, c, v);
+                        const int bin = fHistE3CFloatDeviation->GetBin(k * kE3CNCategories + c + 1, v + 1);
+                        fHistE3CFloatDeviation->SetBinContent(bin, std::max(fHistE3CFloatDeviation->GetBinContent(bin), dev));
+                        E3C_LOG_SETUP(name << " float vs double: max relative deviation per bin " << dev);
+                    }
+                    if (fE3CSparse.thnSparse && hists.Sparse(k, c)) {
+                        //variable binning of the family on 2 (moments) or 3 axes, non-empty cells only
+                        const int dim = (k == kE3CMoments) ? 2 : 3;
+                        int nbins[3];
+                        double xmin[3], xmax[3];
+                        for (int a = 0; a < dim; a++) { nbins[a] = ax[a].NBins(); xmin[a] = ax[a].edges.front(); xmax[a] = ax[a].edges.back(); }
+                        for (int n = 0; n < (k == kE3CMoments ? 2 : 1); n++) {
+                            const std::string nameS = n ? name + "_n" : name;
+                            THnSparseD *hs = new THnSparseD(nameS.c_str(), nameS.c_str(), dim, nbins, xmin, xmax);
+                            for (int a = 0; a < dim; a++) hs->SetBinEdges(a, ax[a].edges.data());
+                            hists.ExportSparse(k, c, v, hs, n == 1);
+                            fOutput->Add(hs);
+                        }
+                        continue;
+                    }
+                    if (k == kE3CMoments) {
+                        TH2 *h = nullptr, *hn = nullptr;
+                        const std::string nameN = name + "_n";
+                        if (single) {
+                            h = new TH2F(name.c_str(), name.c_str(), ax[0].NBins(), ax[0].edges.data(), ax[1].NBins(), ax[1].edges.data());
+                            hn = new TH2F(nameN.c_str(), nameN.c_str(), ax[0].NBins(), ax[0].edges.data(), ax[1].NBins(), ax[1].edges.data());
+                            hists.Export(k, c, v, (TH2F *)h);
+                            hists.ExportCounts(c, v, (TH2F *)hn);
                         }
-                        
-                    }
+                        else {
+                            h = new TH2D(name.c_str(), name.c_str(), ax[0].NBins(), ax[0].edges.data(), ax[1].NBins(), ax[1].edges.data());
+                            hn = new TH2D(nameN.c_str(), nameN.c_str(), ax[0].NBins(), ax[0].edges.data(), ax[1].NBins(), ax[1].edges.data());
+                            hists.Export(k, c, v, (TH2D *)h);
+                            hists.ExportCounts(c, v, (TH2D *)hn);
+                        }
+                        fOutput->Add(h);
+                        fOutput->Add(hn);
+                        continue;
+                    }
+                    if (single) {
+                        TH3F *h = new TH3F(name.c_str(), name.c_str(), ax[0].NBins(), ax[0].edges.data(),
+                                           ax[1].NBins(), ax[1].edges.data(), ax[2].NBins(), ax[2].edges.data());
+                        hists.Export(k, c, v, h);
+                        fOutput->Add(h);
+                        continue;
+                    }
+                    TH3D *h = new TH3D(name.c_str(), name.c_str(), ax[0].NBins(), ax[0].edges.data(),
+                                       ax[1].NBins(), ax[1].edges.data(), ax[2].NBins(), ax[2].edges.data());
+                    hists.Export(k, c, v, h);
+                    fOutput->Add(h);
                 }
             }
+            //the kind is in fOutput now: free its cells before the next one is copied
+            hists.Release(k);
         }
     }
-    else{
-        if(fCout){cout<<" all diff now "<<endl;}
-        for (int i = 0; i < mult; i++)
-        {
-            if(particles.at(i).pt()<corrTrkCut) continue;
-            int i1 = particles.at(i).user_index();
-            
-            for (int  j = 0; j < mult2; j++)
-            {
-                if(particles2.at(j).pt()<corrTrkCut) continue;
-                int i2 = particles2.at(j).user_index();
-                
-                for (int k = 0; k < mult3; k++)
-                {
-                    if(particles3.at(k).pt()<corrTrkCut) continue;
-                    int i3 = particles3.at(k).user_index();
-                    
-                    w_ijk = (1./(jetpt*jetpt*jetpt))*(6*particles.at(i).pt()*particles2.at(j).pt()*particles3.at(k).pt());
-                    w_ijk_tru = (1./(pt*pt*pt))*(particles.at(i).pt()*particles2.at(j).pt()*particles3.at(k).pt());
-                    
-                    w_ijk_3D = (1./(jetpt*jetpt*jetpt))*(particles.at(i).pt()*particles2.at(j).pt()*particles3.at(k).pt());
-                    w_ijk_tru_3D = (1./(pt*pt*pt))*(particles.at(i).pt()*particles2.at(j).pt()*particles3.at(k).pt());
-                    
-                    double dR_ij = delR(particles.at(i), particles2.at(j));
-                    double dR_js = delR(particles2.at(j), particles3.at(k));
-                    double dR_is = delR(particles.at(i), particles3.at(k));
-                    
-                    double R_L = -1;
-                    if(dR_ij>dR_js && dR_ij>dR_is){R_L = dR_ij;}
-                    else if(dR_js>dR_ij && dR_js>dR_is){R_L = dR_js;}
-                    else{R_L = dR_is;}
-                    
-                    if((i1 == 1 || i1 == 0) && i2==-2 && i3 == -3){
-                        if(fCout){cout<<" jmb1mb2 "<<endl;}
-                        
-                        h_JMB1MB2->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_JMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_JMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_JMB1MB2_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_JMB1MB2_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_JMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_JMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_JMB1MB2_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_JMB1MB2_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_JMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_JMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_JMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                
-                            }
-                            else{
-                                h_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                h3_JMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                    if(i1 == 0 && i2==-2 && i3 == -3){
-                        
-                        if(fCout){cout<<" jbmb1mb2 "<<endl;}
-                        
-                        h_BMB1MB2->Fill(jetpt, pt, R_L,w_ijk);
-                        h_BMB1MB2_tru->Fill(jetpt, pt, R_L,w_ijk_tru);
-                        
-                        h3_BMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_BMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_BMB1MB2_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_BMB1MB2_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_BMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_BMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_BMB1MB2_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_BMB1MB2_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_BMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_BMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_BMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_BMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_BMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                
-                            }
-                            else{
-                                h_BMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_BMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_BMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                    if(i1 == 1 && i2==-2 && i3 == -3){
-                        
-                        if(fCout){cout<<" sbmb1mb2 "<<endl;}
-                        
-                        h_SMB1MB2->Fill(jetpt, pt, R_L,w_ijk);
-                        
-                        h3_SMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_SMB1MB2->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_SMB1MB2_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_SMB1MB2_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_SMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_SMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_SMB1MB2_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_SMB1MB2_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_SMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_SMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_SMB1MB2_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_SMB1MB2_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                
-                            }
-                            else{
-                                h_SMB1MB2_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_SMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_SMB1MB2_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                    
-                    if(i1 == -2 && i2==-3 && i3 == -4){
-                        
-                        if(fCout){cout<<" mb1mb2mb3 "<<endl;}
-                        
-                        h_MB1MB2MB3->Fill(jetpt, pt, R_L,w_ijk);
-                        h_MB1MB2MB3_tru->Fill(jetpt, pt, R_L,w_ijk_tru);
-                        
-                        h3_MB1MB2MB3->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_MB1MB2MB3->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_MB1MB2MB3->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_MB1MB2MB3->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_MB1MB2MB3->Fill(jetpt, R_L,w_ijk_3D);
-                        h3_MB1MB2MB3->Fill(jetpt, R_L,w_ijk_3D);
-                        
-                        if(ifMatchedJet){
-                            if(cfactor){
-                                h_MB1MB2MB3_c_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_MB1MB2MB3_tru_c_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_MB1MB2MB3_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_MB1MB2MB3_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_c_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                
-                            }
-                            else{
-                                h_MB1MB2MB3_m->Fill(jetpt, pt, R_L,w_ijk);
-                                h_MB1MB2MB3_tru_m->Fill(jetpt, pt, R_L,w_ijk_tru);
-                                
-                                h3_MB1MB2MB3_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_m->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_m->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                h3_MB1MB2MB3_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                                h3_MB1MB2MB3_tru_m->Fill(pt, R_L,w_ijk_tru_3D);
-                            }
-                        }
-                        else{
-                            if(cfactor){
-                                h_MB1MB2MB3_c_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_MB1MB2MB3_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_c_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                                
-                            }
-                            else{
-                                h_MB1MB2MB3_um->Fill(jetpt, pt, R_L,w_ijk);
-                                
-                                h3_MB1MB2MB3_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_um->Fill(jetpt, R_L,w_ijk_3D);
-                                h3_MB1MB2MB3_um->Fill(jetpt, R_L,w_ijk_3D);
-                                
-                            }
-                        }
-                    }
-                }
+#if E3C_INSTRUMENT
+    //terms and flushes of the serial workspace, the thread pool and its tiles; the flushes and the
+    //replay of the parallel records make the fills stage, and the entries the fills per family
+    E3CCounters counters;
+    counters.Add(fE3CWork);
+    if (fE3CParallel) fE3CParallel->AddCounters(counters);
+    fHistE3CCounters->SetBinContent(1, counters.evaluated);
+    fHistE3CCounters->SetBinContent(2, counters.filled);
+    fHistE3CCounters->SetBinContent(3, counters.flushes);
+    fHistE3CStageTime->Fill(kE3CStageFills, 1e6 * counters.flushSeconds);
+    fHistE3CStageCalls->Fill(kE3CStageFills, counters.flushes);
+    for (int k = 0; k < kE3CNKinds; k++)
+        for (int c = 0; c < kE3CNCategories; c++)
+            for (int v = 0; v < kE3CNVariants; v++)
+                if (fE3CHists.Booked(k, c, v)) fHistE3CFamilyFills->SetBinContent(k * kE3CNCategories + c + 1, v + 1, fE3CHists.Entries(k, c, v));
+#endif
+    //N-point correlators: hE<n>C_<label><variant suffix>, e.g. hE4C_MJ, hE3C_JJMB_m
+    for (int n = 2; n <= fE3CENC.order; n++) {
+        E3CHistBank &bank = fE3CENCHists[n];
+        for (int f = 0; f < (int)fE3CENC.labels[n].size(); f++) {
+            const E3CAxis *ax = bank.axis[kE3CResponse][f];
+            for (int v = 0; v < kE3CNVariants; v++) {
+                if (!bank.Booked(kE3CResponse, f, v)) continue;
+                const std::string name = Form("hE%dC_%s%s", n, fE3CENC.labels[n][f].c_str(), kE3CVariantSuffix[v]);
+                TH3D *h = new TH3D(name.c_str(), name.c_str(), ax[0].NBins(), ax[0].edges.data(),
+                                   ax[1].NBins(), ax[1].edges.data(), ax[2].NBins(), ax[2].edges.data());
+                bank.Export(kE3CResponse, f, v, h);
+                fOutput->Add(h);
             }
         }
+        bank.Release(kE3CResponse);
     }
+    //joins the helper threads
+    delete fE3CParallel;
+    fE3CParallel = nullptr;
+    PostData(1, fOutput);
+}
+// //______________________________________________________________________
+// //AddTask configuration of the E3C engine: kE3CEngineAuto (default) lets the dispatcher choose,
+// //kE3CEngineTriplet / kE3CEngineSortedPairs fix it for every call
+void AliAnalysisTaskJetsEECpbpb::SetE3CEngine(E3CEngine engine)
+{
+    fE3CEngine = engine;
+}
+// //E3C histograms to book, as E3CFamilySelection bit masks; ComputeE3C skips the rest.
+// //E.g. SetE3CFamilies(kE3CVariantsData) for data trains: inclusive copies only, no _m/_um/_c/_tru;
+// //kinds = kE3CKindsAll brings back the h3 weight-axis histograms next to the hw moments
+void AliAnalysisTaskJetsEECpbpb::SetE3CFamilies(unsigned int variants, unsigned int categories, unsigned int kinds)
+{
+    fE3CFamilies.variants = variants;
+    fE3CFamilies.categories = categories;
+    fE3CFamilies.kinds = kinds;
+}
+// //E3C families stored as float bins (kind and category masks, see E3CPrecisionSelection), e.g.
+// //SetE3CSinglePrecision(1u << kE3CResponse) for all response families; validate also keeps them in
+// //double and writes the largest float/double deviation per histogram to hE3CFloatDeviation
+void AliAnalysisTaskJetsEECpbpb::SetE3CSinglePrecision(unsigned int kinds, unsigned int categories, bool validate)
+{
+    fE3CPrecision.kinds = kinds;
+    fE3CPrecision.categories = categories;
+    fE3CPrecision.validate = validate;
+}
+// //E3C families kept as hashed blocks of their non-empty cells (kind and category masks, see
+// //E3CSparseSelection), so finer binning only costs memory where the fills land. They are written
+// //as TH3D/TH2D (same names as the dense ones) or, with thnSparse, as THnSparseD
+void AliAnalysisTaskJetsEECpbpb::SetE3CSparse(unsigned int kinds, unsigned int categories, bool thnSparse)
+{
+    fE3CSparse.kinds = kinds;
+    fE3CSparse.categories = categories;
+    fE3CSparse.thnSparse = thnSparse;
+}
+// //Number of threads for the ComputeE3C calls of an event (1, the default, computes them in place);
+// //the histograms are bitwise the same for any value. The pool is started in UserCreateOutputObjects
+void AliAnalysisTaskJetsEECpbpb::SetE3CThreads(int nThreads)
+{
+    fE3CThreads = std::max(1, nThreads);
+}
+// //With SetE3CThreads, triplet-engine calls from this multiplicity on are also split over the
+// //threads by particle ranges of their first list (off by default). The result is the same for any
+// //number of threads but can differ from the unsplit one in the last bits of the sums
+void AliAnalysisTaskJetsEECpbpb::SetE3CSplitThreshold(int multiplicity)
+{
+    fE3CSplitThreshold = multiplicity > 0 ? multiplicity : INT_MAX;
+}
+// //Event-level cache of the thermal cones: jets whose cone axes agree within tolerance (0: exactly)
+// //share the selected tracks and, in the serial mode, the response and moments sums of the MB-only
+// //calls, rescaled per jet. Lookups and hits are written to hE3CConeCache
+void AliAnalysisTaskJetsEECpbpb::SetE3CConeCache(bool enable, double tolerance)
+{
+    fE3CConeCache.enabled = enable;
+    fE3CConeCache.tolerance = std::max(0., tolerance);
+}
+// //nCones thermal cones per jet (rounded up to whole samples of three) at random positions, away
+// //from the jet, its recoil and each other, reproducible from seed and the jet direction; every
+// //sample adds to the MB histograms, hE3CConeSamples counts the samples per jet for the normalisation.
+// //nCones = 0 goes back to the three fixed cones
+void AliAnalysisTaskJetsEECpbpb::SetE3CCones(int nCones, unsigned long long seed)
+{
+    fE3CConeSampler.random = nCones > 0;
+    fE3CConeSampler.nCones = nCones > 0 ? std::min(kE3CMaxCones, 3 * ((nCones + 2) / 3)) : 3;
+    fE3CConeSampler.seed = seed;
+}
+// //Extra thermal-cone radii next to fConeR (up to kE3CMaxRadii in all), e.g. {0.2, 0.3} for a cone-radius
+// //systematic in the same pass: each track is assigned to every radius by one distance, the cone
+// //calls are enumerated once for all radii, and the families with a thermal-cone particle are
+// //written again per extra radius with the suffix _R<100 R> (h3_MB1MB1MB1_R020, ...)
+void AliAnalysisTaskJetsEECpbpb::SetE3CConeRadii(const std::vector<double> &radii)
+{
+    fE3CConeRadii = radii;
+}
+// //N-point correlator family for ComputeENC: order 2 (EEC) to kE3CMaxOrder, label as in
+// //E3CENCFamilies, e.g. AddE3CENCFamily(4, "MJ") for the E4C of the jet, AddE3CENCFamily(4, "JJMBMB")
+// //for its two-cone background term; false if the label is not understood
+bool AliAnalysisTaskJetsEECpbpb::AddE3CENCFamily(int order, const char *label)
+{
+    return fE3CENC.Add(order, label);
+}
+// //N-point correlator sets with R_L at or above rlMax are not extended (nor filled), which is
+// //what makes the E4C affordable on Pb-Pb jets; the overflow and the R_L bins from rlMax on
+// //then miss those terms, so rlMax should be at least the upper edge of the R_L range of interest
+void AliAnalysisTaskJetsEECpbpb::SetE3CENCPruning(double rlMax)
+{
+    fE3CENC.rlMax = rlMax > 0 ? rlMax : HUGE_VAL;
+}
+// //Binary trace of the last capacity track snapshots, cone searches and ComputeE3C calls (E3CTrace,
+// //0 = off): event, jet, stage, multiplicities and duration per record. A record above anomalyMicros
+// //(0: never) writes the ring to <path>_<n>.bin, at most ten times per job; DumpE3CTrace on demand.
+// //In the AddTask, e.g. task->SetE3CTrace(4096, 2e5, "E3CTrace"): the last 4096 records, dumped by
+// //themselves after a call slower than 0.2 s
+void AliAnalysisTaskJetsEECpbpb::SetE3CTrace(int capacity, double anomalyMicros, const char *path)
+{
+    fE3CTrace.Configure(capacity);
+    fE3CTrace.anomalyMicros = anomalyMicros;
+    fE3CTrace.path = path;
+}
+// //false if the trace is off or the file cannot be written. Called from UserExec, e.g. at the end of
+// //an event that looks wrong, to keep the calls that led to it: DumpE3CTrace("E3CTrace_event.bin")
+bool AliAnalysisTaskJetsEECpbpb::DumpE3CTrace(const char *file) const
+{
+    return fE3CTrace.Enabled() && fE3CTrace.Dump(file);
+}
+// //multiplicity from which mode uses the sorted-pair engine, instead of kE3CEngineThresholdDefault
+void AliAnalysisTaskJetsEECpbpb::SetE3CEngineThreshold(E3CMode mode, int multiplicity)
+{
+    fE3CDispatch.threshold[mode] = multiplicity;
+}
+// //Thresholds not set with SetE3CEngineThreshold timed on the node in UserCreateOutputObjects (off by
+// //default). The engine of a call then depends on the node, and so do the last bits of the output
+void AliAnalysisTaskJetsEECpbpb::SetE3CEngineCalibration(bool calibrate)
+{
+    fE3CEngineCalibration = calibrate;
 }
 // //______________________________________________________________________
-std::tuple<std::vector<fastjet::PseudoJet>, std::vector<fastjet::PseudoJet>, std::vector<fastjet::PseudoJet>>
-AliAnalysisTaskJetsEECpbpb::FindMultipleThermalCones(
+int AliAnalysisTaskJetsEECpbpb::FindMultipleThermalCones(
     AliEmcalJet *fJetEmb, AliJetContainer *fJetContEmb, double ptSub,
     AliEmcalJet *fJet, AliJetContainer *fJet_detCont,
-    AliEmcalJet *fJet_tru, AliJetContainer *fJet_truCont) 
+    AliEmcalJet *fJet_tru, AliJetContainer *fJet_truCont,
+    const E3CParticleBlock *cones[kE3CMaxCones]) 
 {
-    std::vector<fastjet::PseudoJet> coneParticles1, coneParticles2, coneParticles3; // Separate vectors for each cone
+    // cones[k] points to the block of cone k, tagged -2 - k % 3 (cones 3g, 3g+1, 3g+2 are the MB1,
+    // MB2, MB3 of sample g), ready for ComputeE3C and valid until the next StartE3CEvent: a block
+    // of the event pool fE3CBlocks or of the cone cache. Returns the number of cones, 3 without
+    // SetE3CCones
+    E3C_STAGE(kE3CStageCones, 0);
+    const auto start = std::chrono::steady_clock::now();
 
     // Jet kinematics
     Float_t jet_embphi = fJetEmb->Phi();
     Float_t jet_embeta = fJetEmb->Eta();
 
-    // Anti-jet location (π - jet_embphi)
-    Float_t anti_jet_phi = jet_embphi + TMath::Pi();
-    if (anti_jet_phi > TMath::TwoPi()) anti_jet_phi -= TMath::TwoPi();
-
-    Double_t Axis1_Perp, Axis2_Shifted, Axis3_Offset;
-    Double_t dPhi1, dPhi2, dPhi3, dEta1, dEta2, dEta3;
-    Double_t fEtaMC;
-    fastjet::PseudoJet PseudoTracks;
+    // Cone axes in the frame of the track phi; with nested radii the tracks are selected up to the
+    // largest and sorted into radii by E3CFillNested
+    const double coneR = fE3CRadii[fE3CNRadii - 1];
+    double axisEta[kE3CMaxCones], axisPhi[kE3CMaxCones];
+    int nCones = 3;
+    if (fE3CConeSampler.random) {
+        nCones = fE3CConeSampler.Place(jet_embeta, jet_embphi, coneR, fEtaCutValue, axisEta, axisPhi);
+    }
+    else {
+        // Anti-jet location (π - jet_embphi)
+        Float_t anti_jet_phi = jet_embphi + TMath::Pi();
+        if (anti_jet_phi > TMath::TwoPi()) anti_jet_phi -= TMath::TwoPi();
 
-    // **Cone 1: Perpendicular to jet axis (π/2 shift)**
-    Axis1_Perp = jet_embphi + (TMath::Pi() / 2.);
-    if (Axis1_Perp > TMath::TwoPi()) Axis1_Perp -= TMath::TwoPi();
+        Double_t Axis1_Perp, Axis2_Shifted, Axis3_Offset;
 
-    // Ensure Cone 1 does not overlap with anti-jet
-    if (TMath::Abs(Axis1_Perp - anti_jet_phi) < fConeR) {
-        Axis1_Perp += fConeR;
+        // **Cone 1: Perpendicular to jet axis (π/2 shift)**
+        Axis1_Perp = jet_embphi + (TMath::Pi() / 2.);
         if (Axis1_Perp > TMath::TwoPi()) Axis1_Perp -= TMath::TwoPi();
-    }
 
-    // **Cone 2: Shift φ by 0.6 radians and reflect in η**
-    Axis2_Shifted = jet_embphi + 0.6;
-    if (Axis2_Shifted > TMath::TwoPi()) Axis2_Shifted -= TMath::TwoPi();
-    Float_t eta_reflected = -jet_embeta; // Reflect in eta
+        // Ensure Cone 1 does not overlap with anti-jet
+        if (TMath::Abs(Axis1_Perp - anti_jet_phi) < fConeR) {
+            Axis1_Perp += fConeR;
+            if (Axis1_Perp > TMath::TwoPi()) Axis1_Perp -= TMath::TwoPi();
+        }
 
-    // Ensure Cone 2 does not overlap with Jet or Anti-Jet
-    if (TMath::Sqrt((jet_embphi - Axis2_Shifted) * (jet_embphi - Axis2_Shifted) +
-                    (jet_embeta - eta_reflected) * (jet_embeta - eta_reflected)) < fConeR ||
-        TMath::Sqrt((anti_jet_phi - Axis2_Shifted) * (anti_jet_phi - Axis2_Shifted)) < fConeR) {
-        Axis2_Shifted += fConeR;
+        // **Cone 2: Shift φ by 0.6 radians and reflect in η**
+        Axis2_Shifted = jet_embphi + 0.6;
         if (Axis2_Shifted > TMath::TwoPi()) Axis2_Shifted -= TMath::TwoPi();
-    }
-
-    // **Cone 3: 0.6 away from Cone 2, same η as the jet**
-    Axis3_Offset = Axis2_Shifted + 0.6;
-    if (Axis3_Offset > TMath::TwoPi()) Axis3_Offset -= TMath::TwoPi();
+        Float_t eta_reflected = -jet_embeta; // Reflect in eta
+
+        // Ensure Cone 2 does not overlap with Jet or Anti-Jet
+        if (TMath::Sqrt((jet_embphi - Axis2_Shifted) * (jet_embphi - Axis2_Shifted) +
+                        (jet_embeta - eta_reflected) * (jet_embeta - eta_reflected)) < fConeR ||
+            TMath::Sqrt((anti_jet_phi - Axis2_Shifted) * (anti_jet_phi - Axis2_Shifted)) < fConeR) {
+            Axis2_Shifted += fConeR;
+            if (Axis2_Shifted > TMath::TwoPi()) Axis2_Shifted -= TMath::TwoPi();
+        }
 
-    // Ensure Cone 3 does not overlap with Cone 1, Cone 2, or Anti-Jet
-    if (TMath::Sqrt((Axis3_Offset - Axis1_Perp) * (Axis3_Offset - Axis1_Perp) +
-                    (jet_embeta - eta_reflected) * (jet_embeta - eta_reflected)) < fConeR ||
-        TMath::Sqrt((Axis3_Offset - Axis2_Shifted) * (Axis3_Offset - Axis2_Shifted)) < fConeR ||
-        TMath::Sqrt((Axis3_Offset - anti_jet_phi) * (Axis3_Offset - anti_jet_phi)) < fConeR) {
-        Axis3_Offset += fConeR;
+        // **Cone 3: 0.6 away from Cone 2, same η as the jet**
+        Axis3_Offset = Axis2_Shifted + 0.6;
         if (Axis3_Offset > TMath::TwoPi()) Axis3_Offset -= TMath::TwoPi();
-    }
 
+        // Ensure Cone 3 does not overlap with Cone 1, Cone 2, or Anti-Jet
+        if (TMath::Sqrt((Axis3_Offset - Axis1_Perp) * (Axis3_Offset - Axis1_Perp) +
+                        (jet_embeta - eta_reflected) * (jet_embeta - eta_reflected)) < fConeR ||
+            TMath::Sqrt((Axis3_Offset - Axis2_Shifted) * (Axis3_Offset - Axis2_Shifted)) < fConeR ||
+            TMath::Sqrt((Axis3_Offset - anti_jet_phi) * (Axis3_Offset - anti_jet_phi)) < fConeR) {
+            Axis3_Offset += fConeR;
+            if (Axis3_Offset > TMath::TwoPi()) Axis3_Offset -= TMath::TwoPi();
+        }
+
+        // These axes are compared with the track phi shifted by pi, i.e. they sit at axis - pi
+        const double legacyEta[3] = {jet_embeta, eta_reflected, jet_embeta};
+        const double legacyPhi[3] = {Axis1_Perp, Axis2_Shifted, Axis3_Offset};
+        for (int k = 0; k < 3; k++) {
+            axisEta[k] = legacyEta[k];
+            axisPhi[k] = legacyPhi[k] - TMath::Pi();
+        }
+    }
+    fHistE3CConeSamples->Fill(nCones / 3);
+
+    // Cones already selected for an earlier jet of the event come from the cone cache, the
+    // others are filled into new blocks: with a few, each from a grid query; with more, all in
+    // one pass over the snapshot that tests every track against all their axes
+    const E3CTrackSnapshot &tracks = fE3CTracks;
+    E3CParticleBlock *fill[kE3CMaxCones];
+    int fillCode[kE3CMaxCones];
+    double fillEta[kE3CMaxCones], fillPhi[kE3CMaxCones];
+    int nFill = 0;
+    for (int k = 0; k < nCones; k++) {
+        E3CParticleBlock *cone;
+        if (fE3CConeCache.enabled) {
+            bool fresh;
+            cone = fE3CConeCache.Find(-2 - k % 3, axisEta[k], axisPhi[k], corrTrkCut, fE3CBlocks, fresh);
+            cones[k] = cone;
+            if (!fresh) continue;
+        }
+        else cones[k] = cone = &fE3CBlocks.Get();
+        fill[nFill] = cone;
+        fillCode[nFill] = -2 - k % 3;
+        fillEta[nFill] = axisEta[k];
+        fillPhi[nFill++] = axisPhi[k];
+    }
+    if (nFill <= 3) {
+        for (int j = 0; j < nFill; j++) fE3CTrackGrid.Query(fillEta[j], fillPhi[j], coneR, fE3CConeRows[j]);
+    }
+    else E3CConeSampler::Assign(tracks.eta.data(), tracks.phi.data(), tracks.Size(), fillEta, fillPhi, nFill, coneR, fE3CConeRows);
+    for (int j = 0; j < nFill; j++) {
+        if (fE3CNRadii > 1) {
+            E3CFillNested(tracks, fE3CConeRows[j], fillEta[j], fillPhi[j], fE3CRadii, fE3CNRadii, corrTrkCut, fillCode[j], *fill[j]);
+            continue;
+        }
+        for (int i : fE3CConeRows[j]) {
+            if (tracks.pt[i] < corrTrkCut) continue;
+            fill[j]->Add(tracks, i, fillCode[j]);
+        }
+    }
+    int coneTracks = 0;
+    for (int j = 0; j < nFill; j++) {
+        E3C_INSTR(fHistE3CConeTracks->Fill(fill[j]->Size());)
+        coneTracks += fill[j]->Size();
+    }
+    E3C_STAGE_MULTIPLICITY(coneTracks);
+    fE3CTrace.Push(fE3CEvents - 1, fE3CJet, kE3CStageCones, nCones, coneTracks, 0,
+                   std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count(),
+                   fJetEmb->Pt());
+    E3C_LOG_CALL("E3C jet " << fE3CJet << ": " << nCones << " thermal cones");
+    return nCones;
+}
+// //______________________________________________________________________
+// //Once per event, at the top of UserExec: frees the blocks of the previous event (fE3CBlocks,
+// //the cone cache) and reads the accepted tracks of all particle containers, cut on fEtaCutValue
+// //and fMinENCtrackPt, in one pass into the snapshot fE3CTracks and its eta-phi grid. The cone
+// //queries of FindMultipleThermalCones and FillE3CJetBlock read these instead of walking the
+// //containers for every jet
+void AliAnalysisTaskJetsEECpbpb::StartE3CEvent()
+{
+    E3C_STAGE(kE3CStageTracks, 0);
+    const auto start = std::chrono::steady_clock::now();
+    //allocations of the previous event; 0 once the buffers have grown to the largest jets and cones
+    const int allocations = fE3CBlocks.Reset();
+    if (fE3CEvents++) fHistE3CAllocations->Fill(allocations);
+    fE3CConeCache.Clear();
+    fE3CTracks.Clear();
     AliParticleContainer *partCont = 0;
     TIter nextPartCont(&fParticleCollArray);
     while ((partCont = static_cast<AliParticleContainer *>(nextPartCont()))) {
+        fE3CTracks.AddContainer(partCont->GetNParticles());
         AliParticleIterableMomentumContainer itcont = partCont->accepted_momentum();
         for (AliParticleIterableMomentumContainer::iterator it = itcont.begin(); it != itcont.end(); it++) {
             AliVTrack *particle = static_cast<AliVTrack *>(it->second);
             AliAODTrack *trackReal = (AliAODTrack *)(particle);
 
             if (!trackReal) continue;
-
-            fEtaMC = trackReal->Eta();
-            if (TMath::Abs(fEtaMC) > fEtaCutValue) continue;
+            if (TMath::Abs(trackReal->Eta()) > fEtaCutValue) continue;
             if (trackReal->Pt() < fMinENCtrackPt) continue;
-
-            Float_t mod_track_phi = trackReal->Phi() + TMath::Pi();
-
-            // Calculate distances to cones
-            dPhi1 = TMath::Abs(mod_track_phi - Axis1_Perp);
-            dPhi1 = (dPhi1 > TMath::Pi()) ? 2 * TMath::Pi() - dPhi1 : dPhi1;
-            dEta1 = jet_embeta - trackReal->Eta();
-            double distanceCone1 = TMath::Sqrt(dPhi1 * dPhi1 + dEta1 * dEta1);
-
-            dPhi2 = TMath::Abs(mod_track_phi - Axis2_Shifted);
-            dPhi2 = (dPhi2 > TMath::Pi()) ? 2 * TMath::Pi() - dPhi2 : dPhi2;
-            dEta2 = eta_reflected - trackReal->Eta();
-            double distanceCone2 = TMath::Sqrt(dPhi2 * dPhi2 + dEta2 * dEta2);
-
-            dPhi3 = TMath::Abs(mod_track_phi - Axis3_Offset);
-            dPhi3 = (dPhi3 > TMath::Pi()) ? 2 * TMath::Pi() - dPhi3 : dPhi3;
-            dEta3 = jet_embeta - trackReal->Eta();
-            double distanceCone3 = TMath::Sqrt(dPhi3 * dPhi3 + dEta3 * dEta3);
-
-            // Check if the track is within any of the cones
-            if (distanceCone1 < fConeR) {
-                PseudoTracks.reset(trackReal->Px(), trackReal->Py(), trackReal->Pz(), trackReal->E());
-                coneParticles1.push_back(PseudoTracks);
-            }
-            if (distanceCone2 < fConeR) {
-                PseudoTracks.reset(trackReal->Px(), trackReal->Py(), trackReal->Pz(), trackReal->E());
-                coneParticles2.push_back(PseudoTracks);
-            }
-            if (distanceCone3 < fConeR) {
-                PseudoTracks.reset(trackReal->Px(), trackReal->Py(), trackReal->Pz(), trackReal->E());
-                coneParticles3.push_back(PseudoTracks);
-            }
+            const AliTLorentzVector &mom = it->first;
+            fE3CTracks.Add(it.current_index(), mom.Px(), mom.Py(), mom.Pz(), mom.E(), trackReal->Pt(), trackReal->Eta(), trackReal->Phi());
         }
     }
-    return std::make_tuple(coneParticles1, coneParticles2, coneParticles3);
+    fE3CTrackGrid.Build(fE3CTracks.eta, fE3CTracks.phi, fEtaCutValue, fConeR);
+    E3C_STAGE_MULTIPLICITY(fE3CTracks.Size());
+    fE3CJet = -1;
+    fE3CTrace.Push(fE3CEvents - 1, fE3CJet, kE3CStageTracks, fE3CTracks.Size(), 0, 0,
+                   std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    E3C_LOG_EVENT("E3C event " << fE3CEvents - 1 << ": " << fE3CTracks.Size() << " tracks");
+}
+// //______________________________________________________________________
+// //Constituents of jet (tracks of its particle container) from the event snapshot into block, tagged
+// //cat and cut on ptMin. Constituents outside the snapshot cuts are dropped, as in the cones. Jets
+// //whose constituents carry per-track origin codes still use E3CParticleBlock::Fill on the PseudoJets
+void AliAnalysisTaskJetsEECpbpb::FillE3CJetBlock(AliEmcalJet *jet, AliJetContainer *jetCont, double ptMin, int cat, E3CParticleBlock &block)
+{
+    E3C_STAGE(kE3CStageJetBlock, jet->GetNumberOfTracks());
+    fE3CJet++;
+    block.Clear();
+    const int c = fParticleCollArray.IndexOf(jetCont->GetParticleContainer());
+    block.Reserve(jet->GetNumberOfTracks());
+    for (int i = 0; i < jet->GetNumberOfTracks(); i++) {
+        const int row = fE3CTracks.Row(c, jet->TrackAt(i));
+        if (row < 0 || fE3CTracks.pt[row] < ptMin) continue;
+        block.Add(fE3CTracks, row, cat);
+    }
 }
 
 //This is how to use them
-std::vector<fastjet::PseudoJet> cone1, cone2, cone3;
-std::tie(cone1, cone2, cone3) = FindMultipleRandomCones(fJetEmb, fJetContEmb, ptSub, fJet, fJet_detCont, fJet_tru, fJet_truCont);
-// Now use them as inputs to ComputeE3C
-ComputeE3C(cone1, cone2, cone3, jetpt, pt, "someTypeSame", "someType", true);
+StartE3CEvent(); // once per event, at the top of UserExec
+// per jet, blocks from the event pool
+E3CParticleBlock &jetBlock = fE3CBlocks.Get();
+FillE3CJetBlock(fJet, fJet_detCont, corrTrkCut, 1, jetBlock); // or jetBlock.Fill(constituents, corrTrkCut) for mixed origin codes
+const E3CParticleBlock *cones[kE3CMaxCones];
+const int nCones = FindMultipleThermalCones(fJetEmb, fJetContEmb, ptSub, fJet, fJet_detCont, fJet_tru, fJet_truCont, cones);
+// Now use them as inputs to ComputeE3C, the cone terms once per sample of three cones
+ComputeE3C(jetBlock, jetBlock, jetBlock, jetpt, pt, kE3CSameJet, true);
+for (int g = 0; g < nCones; g += 3) {
+    ComputeE3C(jetBlock, *cones[g], *cones[g + 1], jetpt, pt, kE3CAllDiff, true);
+    ComputeE3C(*cones[g], *cones[g + 1], *cones[g + 2], jetpt, pt, kE3CAllDiff, true);
+}
+// N-point correlators (AddE3CENCFamily), all orders at once: the jet alone, or with a sample of
+// cones appended for the mixed terms
+E3CParticleBlock &encBlock = fE3CBlocks.Get();
+encBlock = jetBlock;
+encBlock.Append(*cones[0]);
+encBlock.Append(*cones[1]);
+ComputeENC(encBlock, jetpt, pt, true);
@@ -0,0 +1,3447 @@
+#ifndef ALIANALYSISTASKJETSEECPBPBE3CCODE_H
+#define ALIANALYSISTASKJETSEECPBPBE3CCODE_H
+
+// Helper types for the E3C part of AliAnalysisTaskJetsEECpbpb.
+// Included from AliAnalysisTaskJetsEECpbpb.h; kept free of ROOT and fastjet
+// so the hot-loop pieces stay plain C++. rootcling and cling parse it
+// through the task header: the SIMD kernels and the thread pool are hidden
+// from them, the task holds the pool by a transient pointer.
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if !defined(__CLING__) && !defined(__ROOTCLING__)
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(__CLING__) && !defined(__ROOTCLING__)
+#define E3C_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+//cone radii of the nested thermal cones (SetE3CConeRadii)
+static const int kE3CMaxRadii = 4;
+//highest order of the N-point correlators (E3CComputeENC)
+static const int kE3CMaxOrder = 4;
+
+//________________________________________________________________________
+//Compact per-jet particle list used by ComputeE3C.
+//cat is the origin code (what used to be the PseudoJet user_index):
+//0 background in the embedded jet, 1 PYTHIA signal, -1 jet background,
+//-2/-3/-4 first/second/third thermal cone
+struct E3CParticleBlock
+{
+    std::vector<double> pt;
+    std::vector<double> eta;
+    std::vector<double> phi;
+    std::vector<signed char> cat;
+    int cone = -1; //E3CConeCache entry the block was copied from, -1 otherwise
+    //nested cone (E3CFillNested): radius r holds the entries [radiusBegin[r], Size());
+    //nRadii = 0 for every other list
+    int nRadii = 0;
+    int radiusBegin[kE3CMaxRadii] = {};
+
+    int Size() const { return static_cast<int>(pt.size()); }
+
+    void Clear()
+    {
+        pt.clear(); eta.clear(); phi.clear(); cat.clear();
+        cone = -1;
+        nRadii = 0;
+    }
+
+    void Reserve(int n)
+    {
+        pt.reserve(n); eta.reserve(n); phi.reserve(n); cat.reserve(n);
+    }
+
+    void Add(double ptIn, double etaIn, double phiIn, int catIn)
+    {
+        pt.push_back(ptIn);
+        eta.push_back(etaIn);
+        phi.push_back(phiIn);
+        cat.push_back(static_cast<signed char>(catIn));
+    }
+
+    template <class Snapshot>
+    void Add(const Snapshot &tracks, int row, int catIn) { Add(tracks.pt[row], tracks.eta[row], tracks.phi[row], catIn); }
+
+    //entries of o after these, e.g. the thermal cones after the jet for E3CComputeENC
+    void Append(const E3CParticleBlock &o)
+    {
+        pt.insert(pt.end(), o.pt.begin(), o.pt.end());
+        eta.insert(eta.end(), o.eta.begin(), o.eta.end());
+        phi.insert(phi.end(), o.phi.begin(), o.phi.end());
+        cat.insert(cat.end(), o.cat.begin(), o.cat.end());
+    }
+
+    //Fill from fastjet::PseudoJet-like particles, dropping those below ptMin.
+    //The origin code is taken from user_index().
+    template <class PJ>
+    void Fill(const std::vector<PJ> &particles, double ptMin)
+    {
+        Clear();
+        Reserve(particles.size());
+        for (const PJ &p : particles) {
+            if (p.pt() < ptMin) continue;
+            Add(p.pt(), p.eta(), p.phi(), p.user_index());
+        }
+    }
+};
+
+//Same definition as AliAnalysisTaskJetsEECpbpb::delR, on block entries
+inline double E3CDeltaR(const E3CParticleBlock &a, int i, const E3CParticleBlock &b, int j)
+{
+    double dphi = std::fabs(a.phi[i] - b.phi[j]);
+    if (dphi > M_PI) dphi = 2. * M_PI - dphi;
+    double deta = a.eta[i] - b.eta[j];
+    return std::sqrt(dphi * dphi + deta * deta);
+}
+
+//________________________________________________________________________
+//Per-event pool of particle blocks for the jet constituents and thermal
+//cones. Get hands out the next block, cleared but with the capacity it
+//had in earlier events, at an address that stays valid for the event;
+//once the buffers have grown to the largest jets and cones, the per-jet
+//path does no heap allocation. Reset at the start of an event frees all
+//blocks and counts what the last event had to allocate.
+struct E3CBlockPool
+{
+    std::vector<std::unique_ptr<E3CParticleBlock>> blocks;
+    std::vector<size_t> capacity; //of each block when handed out
+    int used = 0;
+    int created = 0; //blocks created in the current event
+    int grown = 0;   //blocks whose buffers grew in the last event, set by Reset
+
+    E3CParticleBlock &Get()
+    {
+        if (used == (int)blocks.size()) {
+            blocks.emplace_back(new E3CParticleBlock);
+            capacity.push_back(0);
+            created++;
+        }
+        E3CParticleBlock &b = *blocks[used];
+        b.Clear();
+        capacity[used++] = b.pt.capacity();
+        return b;
+    }
+
+    //returns the allocations of the event just finished: created plus grown blocks
+    int Reset()
+    {
+        grown = 0;
+        for (int i = 0; i < used; i++)
+            if (blocks[i]->pt.capacity() != capacity[i]) grown++;
+        const int allocations = created + grown;
+        used = 0;
+        created = 0;
+        return allocations;
+    }
+};
+
+//________________________________________________________________________
+//Per-event snapshot of the accepted tracks of all particle containers,
+//read once at the top of UserExec: contiguous kinematics per row, the
+//container and in-container index of each row, and the reverse lookup
+//Row(container, index), -1 for tracks that failed the cuts. Cone
+//selection and jet constituents then read rows instead of iterating the
+//containers again.
+struct E3CTrackSnapshot
+{
+    std::vector<double> px, py, pz, E, pt, eta, phi;
+    std::vector<int> container, index;
+    std::vector<int> offset; //first rowOf entry per container
+    std::vector<int> rowOf;  //[offset[container] + index]
+
+    int Size() const { return static_cast<int>(pt.size()); }
+
+    void Clear()
+    {
+        px.clear(); py.clear(); pz.clear(); E.clear(); pt.clear(); eta.clear(); phi.clear();
+        container.clear(); index.clear(); offset.clear(); rowOf.clear();
+    }
+
+    //containers are added in order, with their number of particles
+    //(accepted or not) before their tracks
+    void AddContainer(int nParticles)
+    {
+        offset.push_back((int)rowOf.size());
+        rowOf.resize(rowOf.size() + nParticles, -1);
+    }
+
+    void Add(int idx, double pxIn, double pyIn, double pzIn, double EIn, double ptIn, double etaIn, double phiIn)
+    {
+        const int c = (int)offset.size() - 1;
+        rowOf[offset[c] + idx] = Size();
+        px.push_back(pxIn); py.push_back(pyIn); pz.push_back(pzIn); E.push_back(EIn);
+        pt.push_back(ptIn); eta.push_back(etaIn); phi.push_back(phiIn);
+        container.push_back(c);
+        index.push_back(idx);
+    }
+
+    int Row(int c, int idx) const
+    {
+        if (c < 0 || c >= (int)offset.size() || idx < 0) return -1;
+        const int end = c + 1 < (int)offset.size() ? offset[c + 1] : (int)rowOf.size();
+        return offset[c] + idx < end ? rowOf[offset[c] + idx] : -1;
+    }
+};
+
+//________________________________________________________________________
+//Per-event eta-phi grid over the rows of a track snapshot for the
+//thermal-cone queries. Build sorts the rows by cell (eta rows, phi
+//columns over [0, 2pi)), and Query visits only the cells a cone
+//overlaps: per eta row the phi columns are at most two index spans (phi
+//wrap-around), each track in them tested on the squared distance.
+struct E3CTrackGrid
+{
+    std::vector<double> eta, phi; //sorted by cell, phi in [0, 2pi)
+    std::vector<int> order;       //snapshot row of each sorted track
+    std::vector<int> cellBegin;   //[row * nPhi + column], nEta * nPhi + 1 entries
+    std::vector<int> cellOf, next; //Build scratch
+    double etaMin = 0, cellEta = 1, cellPhi = 2 * M_PI;
+    int nEta = 1, nPhi = 1;
+
+    //etaMax: acceptance of the tracks, cell: target cell size (the cone radius)
+    void Build(const std::vector<double> &etaIn, const std::vector<double> &phiIn, double etaMax, double cell)
+    {
+        etaMin = -etaMax;
+        nEta = std::max(1, (int)std::ceil(2 * etaMax / cell));
+        nPhi = std::max(1, (int)(2 * M_PI / cell));
+        cellEta = 2 * etaMax / nEta;
+        cellPhi = 2 * M_PI / nPhi;
+        const int n = (int)etaIn.size();
+        cellOf.resize(n);
+        cellBegin.assign((size_t)nEta * nPhi + 1, 0);
+        for (int i = 0; i < n; i++) {
+            cellOf[i] = Row(etaIn[i]) * nPhi + Column(Wrap(phiIn[i]));
+            cellBegin[cellOf[i] + 1]++;
+        }
+        for (size_t c = 1; c < cellBegin.size(); c++) cellBegin[c] += cellBegin[c - 1];
+        eta.resize(n); phi.resize(n); order.resize(n);
+        next.assign(cellBegin.begin(), cellBegin.end() - 1);
+        for (int i = 0; i < n; i++) {
+            const int d = next[cellOf[i]]++;
+            eta[d] = etaIn[i];
+            phi[d] = Wrap(phiIn[i]);
+            order[d] = i;
+        }
+    }
+
+    //rows of the tracks within R of (etaAxis, phiAxis), ascending so the
+    //cone keeps the container order
+    void Query(double etaAxis, double phiAxis, double R, std::vector<int> &hits) const
+    {
+        hits.clear();
+        phiAxis = Wrap(phiAxis);
+        const double R2 = R * R;
+        const int r0 = Row(etaAxis - R), r1 = Row(etaAxis + R);
+        const int c0 = (int)std::floor((phiAxis - R) / cellPhi);
+        const int c1 = (int)std::floor((phiAxis + R) / cellPhi);
+        int spans[2][2];
+        int nSpans = 1;
+        if (c1 - c0 + 1 >= nPhi) { spans[0][0] = 0; spans[0][1] = nPhi - 1; }
+        else if (c0 < 0) { spans[0][0] = c0 + nPhi; spans[0][1] = nPhi - 1; spans[1][0] = 0; spans[1][1] = c1; nSpans = 2; }
+        else if (c1 >= nPhi) { spans[0][0] = c0; spans[0][1] = nPhi - 1; spans[1][0] = 0; spans[1][1] = c1 - nPhi; nSpans = 2; }
+        else { spans[0][0] = c0; spans[0][1] = c1; }
+        for (int r = r0; r <= r1; r++) {
+            for (int s = 0; s < nSpans; s++) {
+                const int end = cellBegin[r * nPhi + spans[s][1] + 1];
+                for (int i = cellBegin[r * nPhi + spans[s][0]]; i < end; i++) {
+                    double dphi = std::fabs(phi[i] - phiAxis);
+                    if (dphi > M_PI) dphi = 2. * M_PI - dphi;
+                    const double deta = etaAxis - eta[i];
+                    if (dphi * dphi + deta * deta < R2) hits.push_back(order[i]);
+                }
+            }
+        }
+        std::sort(hits.begin(), hits.end());
+    }
+
+    int Row(double x) const { return std::min(nEta - 1, std::max(0, (int)std::floor((x - etaMin) / cellEta))); }
+    int Column(double x) const { return std::min(nPhi - 1, (int)(x / cellPhi)); }
+    static double Wrap(double x)
+    {
+        x = std::fmod(x, 2 * M_PI);
+        return x < 0 ? x + 2 * M_PI : x;
+    }
+};
+
+//________________________________________________________________________
+//Thermal-cone placement and membership (SetE3CCones). Cones come in
+//samples of three, cone k having the origin code -2 - k % 3, so cones
+//3g, 3g+1, 3g+2 are the MB1, MB2, MB3 of sample g. Without random the
+//three fixed cones of FindMultipleThermalCones are used. With random,
+//Place puts nCones axes uniformly in the acceptance, at least 2R from
+//the jet axis, from the recoil direction in phi and from each other, with
+//a generator seeded from seed and the jet direction, so a jet gets the
+//same cones whatever the order of processing.
+static const int kE3CMaxCones = 30;
+
+struct E3CConeSampler
+{
+    int nCones = 3; //multiple of 3
+    bool random = false;
+    unsigned long long seed = 0;
+    int maxTries = 1000; //per cone
+
+    static double DeltaPhi(double a, double b)
+    {
+        const double d = std::fabs(E3CTrackGrid::Wrap(a) - E3CTrackGrid::Wrap(b));
+        return std::min(d, 2 * M_PI - d);
+    }
+
+    //axes in the frame of the track phi; returns the number placed, nCones
+    //or, if the acceptance is full, fewer rounded down to whole samples
+    int Place(double jetEta, double jetPhi, double R, double etaMax, double *eta, double *phi) const
+    {
+        unsigned long long bits[2];
+        std::memcpy(&bits[0], &jetEta, sizeof(double));
+        std::memcpy(&bits[1], &jetPhi, sizeof(double));
+        unsigned long long state = seed ^ (bits[0] * 0x9e3779b97f4a7c15ULL) ^ (bits[1] * 0xc2b2ae3d27d4eb4fULL);
+        auto uniform = [&state]() {
+            unsigned long long z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return ((z ^ (z >> 31)) >> 11) * (1. / 9007199254740992.);
+        };
+        const double min2 = 4 * R * R;
+        const double etaRange = std::max(0., etaMax - R);
+        int n = 0;
+        for (int tries = 0; n < std::min(nCones, kE3CMaxCones) && tries < maxTries; tries++) {
+            const double e = etaRange * (2 * uniform() - 1);
+            const double f = 2 * M_PI * uniform();
+            auto close = [&](double e2, double f2) {
+                const double dphi = DeltaPhi(f, f2);
+                return dphi * dphi + (e - e2) * (e - e2) < min2;
+            };
+            bool ok = !close(jetEta, jetPhi) && DeltaPhi(f, jetPhi + M_PI) >= 2 * R;
+            for (int k = 0; k < n && ok; k++) ok = !close(eta[k], phi[k]);
+            if (!ok) continue;
+            eta[n] = e;
+            phi[n] = f;
+            n++;
+            tries = -1;
+        }
+        return n - n % 3;
+    }
+
+    //One pass over n tracks: the tracks are taken 64 at a time, each axis
+    //tested against the whole group in a branch-free loop that builds a
+    //bit mask of containing cones per track, and each track is then
+    //appended to the rows of its cones, in track order
+    static void Assign(const double *eta, const double *phi, int n, const double *axEta, const double *axPhi, int K,
+                       double R, std::vector<int> *rows)
+    {
+        const double R2 = R * R;
+        for (int k = 0; k < K; k++) rows[k].clear();
+        unsigned int mask[64];
+        for (int b = 0; b < n; b += 64) {
+            const int m = std::min(64, n - b);
+            std::fill(mask, mask + m, 0u);
+            for (int k = 0; k < K; k++) {
+                const double ea = axEta[k], pa = E3CTrackGrid::Wrap(axPhi[k]);
+                const unsigned int bit = 1u << k;
+                const double *e = eta + b, *f = phi + b;
+                for (int i = 0; i < m; i++) {
+                    double dphi = std::fabs(f[i] - pa);
+                    dphi = std::min(dphi, 2 * M_PI - dphi);
+                    const double deta = e[i] - ea;
+                    mask[i] |= (dphi * dphi + deta * deta < R2) ? bit : 0u;
+                }
+            }
+            for (int i = 0; i < m; i++)
+                for (unsigned int mm = mask[i]; mm; mm &= mm - 1) rows[__builtin_ctz(mm)].push_back(b + i);
+        }
+    }
+};
+
+//Nested cones: the rows of tracks within the largest of the nR ascending
+//radii of the axis (from E3CTrackGrid::Query or E3CConeSampler::Assign),
+//pt >= ptMin, go into block outer shell first, each shell in row order.
+//Radius r then holds the suffix [radiusBegin[r], Size()) of the block.
+inline void E3CFillNested(const E3CTrackSnapshot &tracks, const std::vector<int> &rows, double axEta, double axPhi,
+                          const double *radii, int nR, double ptMin, int code, E3CParticleBlock &block)
+{
+    axPhi = E3CTrackGrid::Wrap(axPhi);
+    auto shell = [&](int i) {
+        const double dphi = E3CConeSampler::DeltaPhi(tracks.phi[i], axPhi);
+        const double deta = tracks.eta[i] - axEta;
+        const double d2 = dphi * dphi + deta * deta;
+        int r = 0;
+        while (r < nR && d2 >= radii[r] * radii[r]) r++;
+        return r; //nR: outside
+    };
+    block.nRadii = nR;
+    for (int r = nR - 1; r >= 0; r--) {
+        block.radiusBegin[r] = block.Size();
+        for (int i : rows)
+            if (tracks.pt[i] >= ptMin && shell(i) == r) block.Add(tracks, i, code);
+    }
+}
+
+//________________________________________________________________________
+//Per-jet cache of pairwise Delta R and pT products.
+//BuildSame keeps the packed upper triangle (i<j) of one block,
+//BuildCross the full rectangle a x b. For fixed i the row over j is
+//contiguous, which is what the triplet k-loops walk.
+struct E3CPairCache
+{
+    int n1 = 0;
+    int n2 = 0;
+    bool same = false;
+    std::vector<double> dR;
+    std::vector<double> ptProd;
+    std::vector<int> rowOffset;
+
+    void BuildSame(const E3CParticleBlock &a)
+    {
+        same = true;
+        n1 = n2 = a.Size();
+        rowOffset.resize(n1 > 0 ? n1 : 0);
+        int npairs = n1 * (n1 - 1) / 2;
+        dR.resize(npairs > 0 ? npairs : 0);
+        ptProd.resize(dR.size());
+        int idx = 0;
+        for (int i = 0; i < n1; i++) {
+            rowOffset[i] = idx - (i + 1); //so that Index(i,j) = rowOffset[i] + j
+            for (int j = i + 1; j < n1; j++, idx++) {
+                dR[idx] = E3CDeltaR(a, i, a, j);
+                ptProd[idx] = a.pt[i] * a.pt[j];
+            }
+        }
+    }
+
+    void BuildCross(const E3CParticleBlock &a, const E3CParticleBlock &b)
+    {
+        same = false;
+        n1 = a.Size();
+        n2 = b.Size();
+        rowOffset.resize(n1);
+        dR.resize(n1 * n2);
+        ptProd.resize(dR.size());
+        int idx = 0;
+        for (int i = 0; i < n1; i++) {
+            rowOffset[i] = idx;
+            for (int j = 0; j < n2; j++, idx++) {
+                dR[idx] = E3CDeltaR(a, i, b, j);
+                ptProd[idx] = a.pt[i] * b.pt[j];
+            }
+        }
+    }
+
+    //same-set caches need i<j
+    int Index(int i, int j) const { return rowOffset[i] + j; }
+    double DeltaR(int i, int j) const { return dR[Index(i, j)]; }
+    double PtProd(int i, int j) const { return ptProd[Index(i, j)]; }
+    //row i starting at column j, contiguous
+    const double *DeltaRRow(int i, int j) const { return &dR[Index(i, j)]; }
+};
+
+//________________________________________________________________________
+//Inner k-loop of the E3C triplet enumeration. For fixed (i,j) it takes the
+//rows dR(j,k), dR(i,k) and pT(k) and writes for every k
+//  RL    = max(dR_ij, dR_jk, dR_ik)
+//  w3D   = pT_i pT_j pT_k * norm      (norm = 1/jetpt^3)
+//  w3DTru= pT_i pT_j pT_k * normTru   (normTru = 1/pt^3)
+//  rlBin = ROOT bin of RL on rlEdges (0 underflow, nEdges overflow), if requested
+struct E3CTripletInput
+{
+    const double *dRjk = nullptr;
+    const double *dRik = nullptr;
+    const double *ptk = nullptr;
+    int n = 0;
+    double dRij = 0;
+    double ptij = 0;
+    double norm = 0;
+    double normTru = 0;
+    const double *rlEdges = nullptr; //optional, nRLEdges ascending edges
+    int nRLEdges = 0;
+};
+
+struct E3CTripletScratch
+{
+    std::vector<double> RL;
+    std::vector<double> w3D;
+    std::vector<double> w3DTru;
+    std::vector<int> rlBin;
+    long evaluated = 0; //terms computed, E3C_INSTRUMENT only
+
+    void Resize(int n)
+    {
+        if ((int)RL.size() >= n) return;
+        RL.resize(n); w3D.resize(n); w3DTru.resize(n); rlBin.resize(n);
+    }
+};
+
+inline void E3CTripletKernelScalar(const E3CTripletInput &in, E3CTripletScratch &out, int kBegin = 0)
+{
+    const double wij = in.ptij * in.norm;
+    const double wijTru = in.ptij * in.normTru;
+    for (int k = kBegin; k < in.n; k++) {
+        double rl = std::max(in.dRij, std::max(in.dRjk[k], in.dRik[k]));
+        out.RL[k] = rl;
+        out.w3D[k] = wij * in.ptk[k];
+        out.w3DTru[k] = wijTru * in.ptk[k];
+        if (in.rlEdges) {
+            int bin = 0;
+            for (int e = 0; e < in.nRLEdges; e++) bin += (rl >= in.rlEdges[e]);
+            out.rlBin[k] = bin;
+        }
+    }
+}
+
+#ifdef E3C_X86_DISPATCH
+__attribute__((target("avx2")))
+inline void E3CTripletKernelAVX2(const E3CTripletInput &in, E3CTripletScratch &out)
+{
+    const __m256d vdRij = _mm256_set1_pd(in.dRij);
+    const __m256d vwij = _mm256_set1_pd(in.ptij * in.norm);
+    const __m256d vwijTru = _mm256_set1_pd(in.ptij * in.normTru);
+    const __m256i one = _mm256_set1_epi64x(1);
+    int k = 0;
+    for (; k + 4 <= in.n; k += 4) {
+        __m256d rl = _mm256_max_pd(vdRij, _mm256_max_pd(_mm256_loadu_pd(in.dRjk + k), _mm256_loadu_pd(in.dRik + k)));
+        __m256d ptk = _mm256_loadu_pd(in.ptk + k);
+        _mm256_storeu_pd(&out.RL[k], rl);
+        _mm256_storeu_pd(&out.w3D[k], _mm256_mul_pd(vwij, ptk));
+        _mm256_storeu_pd(&out.w3DTru[k], _mm256_mul_pd(vwijTru, ptk));
+        if (in.rlEdges) {
+            __m256i bin = _mm256_setzero_si256();
+            for (int e = 0; e < in.nRLEdges; e++) {
+                __m256d ge = _mm256_cmp_pd(rl, _mm256_set1_pd(in.rlEdges[e]), _CMP_GE_OQ);
+                bin = _mm256_add_epi64(bin, _mm256_and_si256(_mm256_castpd_si256(ge), one));
+            }
+            alignas(32) long long b[4];
+            _mm256_store_si256((__m256i *)b, bin);
+            for (int l = 0; l < 4; l++) out.rlBin[k + l] = (int)b[l];
+        }
+    }
+    E3CTripletKernelScalar(in, out, k);
+}
+
+//GCC 12 reports '__Y' may be used uninitialized from inside _mm512_max_pd
+//and _mm512_cvttpd_epi32 (the undefined source operand of the intrinsic
+//headers), a false positive
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+__attribute__((target("avx512f")))
+inline void E3CTripletKernelAVX512(const E3CTripletInput &in, E3CTripletScratch &out)
+{
+    const __m512d vdRij = _mm512_set1_pd(in.dRij);
+    const __m512d vwij = _mm512_set1_pd(in.ptij * in.norm);
+    const __m512d vwijTru = _mm512_set1_pd(in.ptij * in.normTru);
+    int k = 0;
+    for (; k + 8 <= in.n; k += 8) {
+        __m512d rl = _mm512_max_pd(vdRij, _mm512_max_pd(_mm512_loadu_pd(in.dRjk + k), _mm512_loadu_pd(in.dRik + k)));
+        __m512d ptk = _mm512_loadu_pd(in.ptk + k);
+        _mm512_storeu_pd(&out.RL[k], rl);
+        _mm512_storeu_pd(&out.w3D[k], _mm512_mul_pd(vwij, ptk));
+        _mm512_storeu_pd(&out.w3DTru[k], _mm512_mul_pd(vwijTru, ptk));
+        if (in.rlEdges) {
+            const __m512d one = _mm512_set1_pd(1.);
+            __m512d bin = _mm512_setzero_pd();
+            for (int e = 0; e < in.nRLEdges; e++) {
+                __mmask8 ge = _mm512_cmp_pd_mask(rl, _mm512_set1_pd(in.rlEdges[e]), _CMP_GE_OQ);
+                bin = _mm512_mask_add_pd(bin, ge, bin, one);
+            }
+            _mm256_storeu_si256((__m256i *)&out.rlBin[k], _mm512_cvttpd_epi32(bin));
+        }
+    }
+    E3CTripletKernelScalar(in, out, k);
+}
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+typedef void (*E3CTripletKernelFn)(const E3CTripletInput &, E3CTripletScratch &);
+
+inline void E3CTripletKernelScalarFn(const E3CTripletInput &in, E3CTripletScratch &out)
+{
+    E3CTripletKernelScalar(in, out, 0);
+}
+
+//Picks the widest kernel the CPU supports; resolved once per process
+inline E3CTripletKernelFn E3CSelectTripletKernel()
+{
+#ifdef E3C_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return E3CTripletKernelAVX512;
+    if (__builtin_cpu_supports("avx2")) return E3CTripletKernelAVX2;
+#endif
+    return E3CTripletKernelScalarFn;
+}
+
+inline void E3CTripletKernel(const E3CTripletInput &in, E3CTripletScratch &out)
+{
+    static const E3CTripletKernelFn kernel = E3CSelectTripletKernel();
+    out.Resize(in.n);
+    kernel(in, out);
+}
+
+
+//________________________________________________________________________
+//How ComputeE3C combines its particle lists (what used to be the
+//typeSame/type strings)
+enum E3CMode
+{
+    kE3CSameJet = 0, //one list of jet constituents: i<j<k plus the i,j,j and i,i,j terms
+    kE3CSameMB,      //the same for the particles of one thermal cone
+    kE3CTwo,         //particles x pairs of particles2, incl. the i,j,j term
+    kE3CAllDiff,     //one particle from each of the three lists
+    kE3CNModes
+};
+
+constexpr bool E3CSingleList(int mode) { return mode == kE3CSameJet || mode == kE3CSameMB; }
+
+//________________________________________________________________________
+//Stage timers and counters of UserExec, compiled in with
+//-DE3C_INSTRUMENT=1. E3C_STAGE times the rest of a member function of the
+//task with steady_clock and hands (stage, multiplicity, seconds) to its
+//RecordE3CStage; E3C_INSTR(...) keeps a counter update in the engines,
+//which count the terms they evaluate and the terms they give to a booked
+//family. Without E3C_INSTRUMENT both expand to nothing: no clock reads and
+//no counter updates in the loops.
+#ifndef E3C_INSTRUMENT
+#define E3C_INSTRUMENT 0
+#endif
+
+enum E3CStage
+{
+    kE3CStageTracks = 0, //StartE3CEvent: track snapshot and grid
+    kE3CStageJetBlock,   //FillE3CJetBlock
+    kE3CStageCones,      //FindMultipleThermalCones
+    kE3CStageCompute,    //ComputeE3C, one stage per E3CMode from here
+    kE3CStageFills = kE3CStageCompute + kE3CNModes, //accumulator flushes and parallel replay into the bank
+    kE3CStageENC,        //ComputeENC
+    kE3CNStages
+};
+constexpr const char *kE3CStageName[kE3CNStages] = {"tracks", "jet block", "cones", "all same jet", "all same MB",
+                                                    "two", "all different", "fills", "N-point"};
+
+//Adds the seconds of its scope to sum
+struct E3CScopedSum
+{
+    double &sum;
+    const std::chrono::steady_clock::time_point start;
+
+    explicit E3CScopedSum(double &sumIn) : sum(sumIn), start(std::chrono::steady_clock::now()) {}
+    ~E3CScopedSum() { sum += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+};
+
+//Calls record(multiplicity, seconds) at the end of its scope
+template <class Record>
+struct E3CStageTimer
+{
+    Record &record;
+    int multiplicity;
+    const std::chrono::steady_clock::time_point start;
+
+    E3CStageTimer(Record &recordIn, int multiplicityIn)
+        : record(recordIn), multiplicity(multiplicityIn), start(std::chrono::steady_clock::now()) {}
+    ~E3CStageTimer() { record(multiplicity, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()); }
+};
+
+#if E3C_INSTRUMENT
+#define E3C_INSTR(...) __VA_ARGS__
+#define E3C_STAGE(stage, n)                                                                               \
+    auto e3cStageRecord = [this](int e3cMult, double e3cSec) { RecordE3CStage(stage, e3cMult, e3cSec); }; \
+    E3CStageTimer<decltype(e3cStageRecord)> e3cStage(e3cStageRecord, n)
+//multiplicity of the stage when it is only known at the end
+#define E3C_STAGE_MULTIPLICITY(n) e3cStage.multiplicity = (n)
+#else
+#define E3C_INSTR(...)
+#define E3C_STAGE(stage, n)
+#define E3C_STAGE_MULTIPLICITY(n)
+#endif
+
+//________________________________________________________________________
+//Debug output of the task, by level fixed at compile time: E3C_LOG_LEVEL
+//1 (default) keeps the setup messages (booking, configuration, end of
+//job), 2 adds one line per event, 3 one per jet or ComputeE3C call, 4 the
+//per-term ones. Statements above the level are removed by the
+//preprocessor; the kept ones print when fCout is set, as before.
+#ifndef E3C_LOG_LEVEL
+#define E3C_LOG_LEVEL 1
+#endif
+#define E3C_LOG_PRINT(...)                                         \
+    do {                                                           \
+        if (fCout) std::cout << __VA_ARGS__ << std::endl;          \
+    } while (0)
+#if E3C_LOG_LEVEL >= 1
+#define E3C_LOG_SETUP(...) E3C_LOG_PRINT(__VA_ARGS__)
+#else
+#define E3C_LOG_SETUP(...)
+#endif
+#if E3C_LOG_LEVEL >= 2
+#define E3C_LOG_EVENT(...) E3C_LOG_PRINT(__VA_ARGS__)
+#else
+#define E3C_LOG_EVENT(...)
+#endif
+#if E3C_LOG_LEVEL >= 3
+#define E3C_LOG_CALL(...) E3C_LOG_PRINT(__VA_ARGS__)
+#else
+#define E3C_LOG_CALL(...)
+#endif
+#if E3C_LOG_LEVEL >= 4
+#define E3C_LOG_TERM(...) E3C_LOG_PRINT(__VA_ARGS__)
+#else
+#define E3C_LOG_TERM(...)
+#endif
+
+//Binary trace of the last calls (SetE3CTrace), for the diagnosis of slow
+//or odd events on the grid without text output: a fixed ring of records,
+//one per track snapshot, cone search and ComputeE3C call, overwritten
+//oldest first. Dump writes it, oldest record first, after an
+//E3CTraceHeader; with anomalyMicros > 0 a record taking longer dumps the
+//ring to <path>_<n>.bin itself, up to maxDumps times per job.
+struct E3CTraceRecord
+{
+    int32_t event;  //StartE3CEvent calls before, i.e. event index of the job
+    int16_t jet;    //FillE3CJetBlock calls before in the event, -1 before the first
+    int16_t stage;  //E3CStage
+    int32_t n[3];   //tracks; cones and cone tracks; list multiplicities of the call
+    float micros;   //duration
+    float jetpt;    //0 where not per jet
+};
+
+struct E3CTraceHeader
+{
+    char magic[8];       //"E3CTRACE"
+    uint32_t version;    //1
+    uint32_t recordSize; //sizeof(E3CTraceRecord)
+    uint64_t written;    //records pushed in the job
+    uint64_t stored;     //records that follow
+};
+
+struct E3CTrace
+{
+    std::vector<E3CTraceRecord> ring; //power-of-two size, empty = off
+    uint64_t written = 0;
+    double anomalyMicros = 0;
+    int maxDumps = 10;
+    int dumps = 0;
+    std::string path = "E3CTrace";
+
+    bool Enabled() const { return !ring.empty(); }
+
+    //capacity rounded up to a power of two, 0 to switch the trace off
+    void Configure(int capacity)
+    {
+        int n = 1;
+        while (n < capacity) n <<= 1;
+        ring.assign(capacity > 0 ? n : 0, E3CTraceRecord());
+        written = 0;
+        dumps = 0;
+    }
+
+    void Push(int event, int jet, int stage, int n0, int n1, int n2, double micros, double jetpt = 0)
+    {
+        if (ring.empty()) return;
+        ring[written++ & (ring.size() - 1)] = {event, (int16_t)jet, (int16_t)stage, {n0, n1, n2}, (float)micros, (float)jetpt};
+        if (anomalyMicros > 0 && micros > anomalyMicros && dumps < maxDumps)
+            Dump((path + "_" + std::to_string(dumps++) + ".bin").c_str());
+    }
+
+    bool Dump(const char *file) const
+    {
+        std::FILE *f = std::fopen(file, "wb");
+        if (!f) return false;
+        const uint64_t size = ring.size();
+        const uint64_t stored = std::min<uint64_t>(written, size);
+        E3CTraceHeader header = {{'E', '3', 'C', 'T', 'R', 'A', 'C', 'E'}, 1, (uint32_t)sizeof(E3CTraceRecord), written, stored};
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+        for (uint64_t i = written - stored; ok && i < written; i++)
+            ok = std::fwrite(&ring[i & (size - 1)], sizeof(E3CTraceRecord), 1, f) == 1;
+        return std::fclose(f) == 0 && ok;
+    }
+};
+
+//Histogram families filled by ComputeE3C. MJ/MJn are the same-jet
+//correlators (n = particles not tagged 0), the rest the min-bias terms
+enum E3CCategory
+{
+    kE3CMJ = 0, kE3CMJ0, kE3CMJ1, kE3CMJ2, kE3CMJ3,
+    kE3CMB1MB1MB1, kE3CJJMB, kE3CJMBMB, kE3CMB1MB1MB2, kE3CMB1MB2MB2,
+    kE3CJMB1MB2, kE3CMB1MB2MB3,
+    kE3CBMBMB, kE3CSMBMB, kE3CBMB1MB2, kE3CSMB1MB2,
+    kE3CBBMB, kE3CSBMB, kE3CSSMB,
+    kE3CNCategories
+};
+
+//Copies of each family, in histogram-suffix order:
+//"", _m, _um, _c_m, _c_um, _tru_m, _tru_c_m
+enum E3CVariant
+{
+    kE3CIncl = 0, kE3CM, kE3CUM, kE3CCM, kE3CCUM, kE3CTruM, kE3CTruCM,
+    kE3CNVariants
+};
+
+constexpr unsigned int E3CBit(int category) { return 1u << category; }
+
+//Origin code -4..1 to 0..5, anything else to 6 (never classified)
+constexpr int kE3CNCodes = 7;
+constexpr int E3CCodeIndex(int code) { return (code >= -4 && code <= 1) ? code + 4 : 6; }
+
+//Categories of the triple (c1,c2,c3), c1 from particles and c2,c3 from
+//the other lists, as in the original per-mode if chains. J is B (0) or S (1),
+//MB1/MB2/MB3 are -2/-3/-4. Single-return constexpr (C++11): the header
+//also goes through rootcling.
+constexpr bool E3CIsJetCode(int c) { return c == 0 || c == 1; }
+
+constexpr unsigned int E3CClassifyTwo(int c1, int c2, int c3)
+{
+    return (c1 == -2 && E3CIsJetCode(c2) && E3CIsJetCode(c3) ? E3CBit(kE3CJJMB) | E3CBit(c2 != c3 ? kE3CSBMB : (c2 == 0 ? kE3CBBMB : kE3CSSMB)) : 0u) |
+           (E3CIsJetCode(c1) && c2 == -2 && c3 == -2 ? E3CBit(kE3CJMBMB) | E3CBit(c1 == 0 ? kE3CBMBMB : kE3CSMBMB) : 0u) |
+           (c1 == -3 && c2 == -2 && c3 == -2 ? E3CBit(kE3CMB1MB1MB2) : 0u) |
+           (c1 == -2 && c2 == -3 && c3 == -3 ? E3CBit(kE3CMB1MB2MB2) : 0u);
+}
+
+constexpr unsigned int E3CClassifyAllDiff(int c1, int c2, int c3)
+{
+    return (E3CIsJetCode(c1) && c2 == -2 && c3 == -3 ? E3CBit(kE3CJMB1MB2) | E3CBit(c1 == 0 ? kE3CBMB1MB2 : kE3CSMB1MB2) : 0u) |
+           (c1 == -2 && c2 == -3 && c3 == -4 ? E3CBit(kE3CMB1MB2MB3) : 0u);
+}
+
+constexpr unsigned int E3CClassify(int mode, int c1, int c2, int c3)
+{
+    return mode == kE3CSameJet ? E3CBit(kE3CMJ) | E3CBit(kE3CMJ0 + (c1 != 0) + (c2 != 0) + (c3 != 0))
+         : mode == kE3CSameMB  ? E3CBit(kE3CMB1MB1MB1)
+         : mode == kE3CTwo     ? E3CClassifyTwo(c1, c2, c3)
+         : mode == kE3CAllDiff ? E3CClassifyAllDiff(c1, c2, c3)
+                               : 0u;
+}
+
+//Triple index (E3CCodeIndex(c1) * 7 + E3CCodeIndex(c2)) * 7 + E3CCodeIndex(c3)
+constexpr unsigned int E3CClassifyIndex(int mode, int t)
+{
+    return E3CClassify(mode, t / (kE3CNCodes * kE3CNCodes) - 4, t / kE3CNCodes % kE3CNCodes - 4, t % kE3CNCodes - 4);
+}
+
+//0..N-1 as a parameter pack, to spell the table out at compile time
+template <int... I>
+struct E3CIndexList {};
+template <int N, int... I>
+struct E3CMakeIndexList : E3CMakeIndexList<N - 1, N - 1, I...> {};
+template <int... I>
+struct E3CMakeIndexList<0, I...> { typedef E3CIndexList<I...> type; };
+
+template <class List>
+struct E3CCategoryTable;
+
+template <int... T>
+struct E3CCategoryTable<E3CIndexList<T...>>
+{
+    static constexpr int kSize = sizeof...(T);
+    static constexpr unsigned int mask[kE3CNModes][sizeof...(T)] = {
+        {E3CClassifyIndex(kE3CSameJet, T)...},
+        {E3CClassifyIndex(kE3CSameMB, T)...},
+        {E3CClassifyIndex(kE3CTwo, T)...},
+        {E3CClassifyIndex(kE3CAllDiff, T)...}};
+};
+template <int... T>
+constexpr unsigned int E3CCategoryTable<E3CIndexList<T...>>::mask[kE3CNModes][sizeof...(T)];
+static_assert(kE3CNModes == 4, "one row of E3CCategoryTable per mode");
+
+typedef E3CCategoryTable<E3CMakeIndexList<kE3CNCodes * kE3CNCodes * kE3CNCodes>::type> E3CCategoryLUT;
+
+inline unsigned int E3CCategoryMask(E3CMode mode, int c1, int c2, int c3)
+{
+    return E3CCategoryLUT::mask[mode][(E3CCodeIndex(c1) * kE3CNCodes + E3CCodeIndex(c2)) * kE3CNCodes + E3CCodeIndex(c3)];
+}
+
+//________________________________________________________________________
+//O(1) bin lookup on ascending variable-width edges. The range is cut into
+//equal cells of a monotonic coordinate, either x itself or, for positive
+//axes, the IEEE bit pattern of x (piecewise linear in log2 x, so a
+//log-spaced axis gets cells of constant ratio without calling log); the
+//one giving fewer edges per cell is kept. Each cell stores the bin of its
+//low end and Find steps from there, usually zero or one edge.
+//Same result as TAxis::FindBin: 0 underflow, nbins+1 overflow (and NaN)
+struct E3CBinLookup
+{
+    static constexpr int kMaxCells = 4096;
+
+    std::vector<double> edges;
+    std::vector<int> table;
+    double lo = 0, hi = 0;
+    double scale = 0;        //linear cells: cells per unit of x
+    uint64_t bitsLo = 0;     //bit-pattern cells: offset and cell width
+    int shift = -1;          //-1 for linear cells
+    int nCells = 0;
+
+    static uint64_t Bits(double x)
+    {
+        uint64_t b;
+        std::memcpy(&b, &x, sizeof(b));
+        return b;
+    }
+
+    static double FromBits(uint64_t b)
+    {
+        double x;
+        std::memcpy(&x, &b, sizeof(x));
+        return x;
+    }
+
+    int NBins() const { return (int)edges.size() - 1; }
+
+    int Find(double x) const
+    {
+        if (x < lo) return 0;
+        if (!(x < hi)) return NBins() + 1;
+        size_t c = (shift >= 0) ? (size_t)((Bits(x) - bitsLo) >> shift) : (size_t)((x - lo) * scale);
+        if (c >= (size_t)nCells) c = nCells - 1;
+        int bin = table[c];
+        while (x >= edges[bin]) bin++;
+        while (x < edges[bin - 1]) bin--;
+        return bin;
+    }
+
+    void Build(const std::vector<double> &edgesIn)
+    {
+        edges = edgesIn;
+        table.clear();
+        nCells = 0;
+        if (edges.size() < 2) return;
+        const int n = NBins();
+        lo = edges.front();
+        hi = edges.back();
+        nCells = std::min(+kMaxCells, std::max(64, 16 * n)); //+: std::min takes references, kMaxCells has no definition
+
+        //candidate cells: linear, and bit pattern for positive ranges
+        const double linScale = nCells / (hi - lo);
+        int bitShift = -1;
+        if (lo > 0) {
+            const uint64_t span = Bits(hi) - Bits(lo);
+            bitShift = 0;
+            while ((span >> bitShift) >= (uint64_t)nCells) bitShift++;
+        }
+        auto cellOf = [&](double x, int s) -> size_t {
+            return (s >= 0) ? (size_t)((Bits(x) - Bits(lo)) >> s) : (size_t)((x - lo) * linScale);
+        };
+        auto crowding = [&](int s) {
+            int worst = 0, run = 0;
+            size_t prev = ~size_t(0);
+            for (int e = 1; e < n; e++) {
+                const size_t c = cellOf(edges[e], s);
+                run = (c == prev) ? run + 1 : 1;
+                prev = c;
+                worst = std::max(worst, run);
+            }
+            return worst;
+        };
+        shift = (bitShift >= 0 && crowding(bitShift) < crowding(-1)) ? bitShift : -1;
+        scale = linScale;
+        bitsLo = Bits(lo);
+
+        table.resize(nCells);
+        for (int c = 0; c < nCells; c++) {
+            const double x = (shift >= 0) ? FromBits(bitsLo + ((uint64_t)c << shift)) : lo + c / scale;
+            const int bin = (int)(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+            table[c] = std::min(std::max(bin, 1), n);
+        }
+    }
+};
+
+//Bin edges of one histogram axis; Find follows TAxis::FindBin
+//(0 underflow, nbins+1 overflow, low edge inclusive). FindSquared takes
+//x^2 for axes with non-negative edges (Delta R), so callers that only
+//need the bin can skip the sqrt; it differs from Find(sqrt(x2)) only
+//within rounding of an edge.
+struct E3CAxis
+{
+    std::vector<double> edges;
+    E3CBinLookup lookup;
+    E3CBinLookup lookupSq; //on squared edges, empty if an edge is negative
+
+    int NBins() const { return (int)edges.size() - 1; }
+    bool InRange(int bin) const { return bin >= 1 && bin <= NBins(); }
+    int Find(double x) const { return lookup.Find(x); }
+    int FindSquared(double x2) const { return lookupSq.Find(x2); }
+
+    void SetEdges(const std::vector<double> &edgesIn)
+    {
+        edges = edgesIn;
+        lookup.Build(edges);
+        std::vector<double> sq;
+        if (edges.size() >= 2 && edges[0] >= 0)
+            for (double e : edges) sq.push_back(e * e);
+        lookupSq.Build(sq);
+    }
+};
+
+//Histogram kinds routed by ComputeE3C: the (jetpt, pt, R_L) response
+//families filled with the full weight, the (x, R_L, weight) ones filled
+//with unit weight once per ordering, and the (x, R_L) moments holding the
+//exact sum of the per-ordering weights, of their squares and the number
+//of orderings (what FillWeightedSum used to rebuild from the weight axis)
+enum E3CKind
+{
+    kE3CResponse = 0, kE3CWeightAxis, kE3CMoments,
+    kE3CNKinds
+};
+
+//Output names: <prefix><category><suffix><variant suffix>, with
+//hJet_deltaR_/h3Jet_deltaR_/hwJet_deltaR_ and _e3c for MJ..MJ3,
+//h_/h3_/hw_ for the rest
+constexpr const char *kE3CCategoryName[kE3CNCategories] = {
+    "MJ", "MJ0", "MJ1", "MJ2", "MJ3",
+    "MB1MB1MB1", "JJMB", "JMBMB", "MB1MB1MB2", "MB1MB2MB2",
+    "JMB1MB2", "MB1MB2MB3",
+    "BMBMB", "SMBMB", "BMB1MB2", "SMB1MB2",
+    "BBMB", "SBMB", "SSMB"};
+constexpr const char *kE3CVariantSuffix[kE3CNVariants] = {"", "_m", "_um", "_c_m", "_c_um", "_tru_m", "_tru_c_m"};
+
+//Which E3C histograms are booked, as bit masks over E3CKind, E3CCategory
+//and E3CVariant. Set from the AddTask (SetE3CFamilies) and applied in
+//UserCreateOutputObjects; by default every family is booked except the
+//weight-axis ones, which the moments replace
+struct E3CFamilySelection
+{
+    unsigned int kinds = (1u << kE3CResponse) | (1u << kE3CMoments);
+    unsigned int categories = (1u << kE3CNCategories) - 1;
+    unsigned int variants = (1u << kE3CNVariants) - 1;
+
+    bool Selected(int kind, int category, int variant) const
+    {
+        return ((kinds >> kind) & (categories >> category) & (variants >> variant) & 1u) != 0;
+    }
+    bool AnyVariant(unsigned int mask) const { return (variants & mask) != 0; }
+};
+
+//Variant presets for SetE3CFamilies
+constexpr unsigned int kE3CVariantsAll = (1u << kE3CNVariants) - 1;
+constexpr unsigned int kE3CVariantsData = 1u << kE3CIncl;
+constexpr unsigned int kE3CVariantsMatched = (1u << kE3CM) | (1u << kE3CCM) | (1u << kE3CTruM) | (1u << kE3CTruCM);
+constexpr unsigned int kE3CVariantsUnmatched = (1u << kE3CUM) | (1u << kE3CCUM);
+constexpr unsigned int kE3CVariantsCFactor = (1u << kE3CCM) | (1u << kE3CCUM) | (1u << kE3CTruCM);
+constexpr unsigned int kE3CVariantsTruth = (1u << kE3CTruM) | (1u << kE3CTruCM);
+
+//Kind presets; the weight-axis histograms are opt-in
+constexpr unsigned int kE3CKindsDefault = (1u << kE3CResponse) | (1u << kE3CMoments);
+constexpr unsigned int kE3CKindsAll = (1u << kE3CNKinds) - 1;
+
+inline std::string E3CHistName(int kind, int category, int variant)
+{
+    static const char *kPrefix[kE3CNKinds] = {"h_", "h3_", "hw_"};
+    static const char *kPrefixMJ[kE3CNKinds] = {"hJet_deltaR_", "h3Jet_deltaR_", "hwJet_deltaR_"};
+    const bool mj = category <= kE3CMJ3;
+    std::string name = mj ? kPrefixMJ[kind] : kPrefix[kind];
+    name += kE3CCategoryName[category];
+    if (mj) name += "_e3c";
+    return name + kE3CVariantSuffix[variant];
+}
+
+//Families kept in single precision (E3CHistBank::single), as bit masks
+//over E3CKind and E3CCategory; set from the AddTask (SetE3CSinglePrecision).
+//validate keeps a double copy of those families next to the float one so
+//the two can be compared at the end of the job
+struct E3CPrecisionSelection
+{
+    unsigned int kinds = 0;
+    unsigned int categories = (1u << kE3CNCategories) - 1;
+    bool validate = false;
+
+    bool Single(int kind, int category) const { return ((kinds >> kind) & (categories >> category) & 1u) != 0; }
+};
+
+//Double batch in front of the float bins of one kind. Flush adds into it
+//and a bin reaches its float only when the batch is drained (half full,
+//or before export), as one sum rounded once. A float bin therefore sees
+//one addition per batch instead of one per jet and the rounding error
+//grows with the number of batches, a few hundred jets each, not of jets.
+struct E3CFloatStage
+{
+    static constexpr int kBits = 15;
+    static constexpr int kSize = 1 << kBits;
+
+    struct Slot
+    {
+        long bin; //-1 = empty
+        double w, w2, n;
+    };
+    std::vector<Slot> slots; //open addressing on bin, allocated on first use
+    std::vector<int> used;
+
+    //returns true when the stage should be drained
+    bool Add(long bin, double w, double w2, double n)
+    {
+        if (slots.empty()) slots.assign(kSize, Slot{-1, 0, 0, 0});
+        size_t h = (size_t)(((uint64_t)bin * 0x9E3779B97F4A7C15ull) >> (64 - kBits));
+        while (slots[h].bin != bin) {
+            if (slots[h].bin < 0) {
+                slots[h].bin = bin;
+                used.push_back((int)h);
+                break;
+            }
+            h = (h + 1) & (kSize - 1);
+        }
+        Slot &s = slots[h];
+        s.w += w; s.w2 += w2; s.n += n;
+        return used.size() >= (size_t)kSize / 2;
+    }
+
+    //adds every staged bin in double and rounds it once into the float arrays
+    void Drain(float *content, float *sumw2, float *counts)
+    {
+        for (int h : used) {
+            Slot &s = slots[h];
+            content[s.bin] = (float)((double)content[s.bin] + s.w);
+            if (sumw2) sumw2[s.bin] = (float)((double)sumw2[s.bin] + s.w2);
+            if (counts) counts[s.bin] = (float)((double)counts[s.bin] + s.n);
+            s = Slot{-1, 0, 0, 0};
+        }
+        used.clear();
+    }
+};
+
+//Families kept sparse (E3CHistBank::sparse), as bit masks over E3CKind
+//and E3CCategory; set from the AddTask (SetE3CSparse). thnSparse writes
+//them as THnSparseD instead of TH3D/TH2D
+struct E3CSparseSelection
+{
+    unsigned int kinds = 0;
+    unsigned int categories = (1u << kE3CNCategories) - 1;
+    bool thnSparse = false;
+
+    bool Sparse(int kind, int category) const { return ((kinds >> kind) & (categories >> category) & 1u) != 0; }
+};
+
+//Hash of blocks holding the non-empty cells of the sparse families of one
+//kind. A block is kBlock consecutive cells in the index space of the kind
+//(the dense layout, never allocated), with nFields doubles per cell stored
+//field by field: content, then Sumw2 and orderings where the kind has
+//them. Blocks are found through an open-addressing table on the block
+//key, fronted by a small direct-mapped cache that keeps the blocks of the
+//jet pT region being filled one lookup away.
+struct E3CSparseStore
+{
+    static constexpr int kBlockBits = 4;
+    static constexpr int kBlock = 1 << kBlockBits;
+    static constexpr int kCacheBits = 8;
+
+    int nFields = 1;
+    std::vector<long> keys;    //table slots, -1 = empty
+    std::vector<int> blockOf;  //table slot -> block
+    std::vector<long> blockKey;
+    std::vector<double> pool;  //kBlock * nFields per block
+    long cacheKey[1 << kCacheBits];
+    int cacheBlock[1 << kCacheBits];
+
+    E3CSparseStore() { Reset(1); }
+
+    void Reset(int fields)
+    {
+        nFields = fields;
+        keys.assign(1024, -1);
+        blockOf.assign(keys.size(), -1);
+        blockKey.clear();
+        pool.clear();
+        for (int i = 0; i < (1 << kCacheBits); i++) cacheKey[i] = -1;
+    }
+
+    int NBlocks() const { return (int)blockKey.size(); }
+    size_t Bytes() const { return pool.size() * sizeof(double) + keys.size() * (sizeof(long) + sizeof(int)) + blockKey.size() * sizeof(long); }
+
+    static size_t Hash(long key, size_t mask) { return (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> 20) & mask; }
+
+    //block of key, created empty if absent; -1 if absent and !create
+    int Block(long key, bool create)
+    {
+        const int c = (int)(key & ((1 << kCacheBits) - 1));
+        if (cacheKey[c] == key) return cacheBlock[c];
+        const size_t mask = keys.size() - 1;
+        size_t h = Hash(key, mask);
+        while (keys[h] != key) {
+            if (keys[h] < 0) {
+                if (!create) return -1;
+                keys[h] = key;
+                blockOf[h] = NBlocks();
+                blockKey.push_back(key);
+                pool.resize(pool.size() + (size_t)kBlock * nFields, 0.);
+                if (2 * blockKey.size() > keys.size()) { Rehash(); return Block(key, false); }
+                break;
+            }
+            h = (h + 1) & mask;
+        }
+        cacheKey[c] = key;
+        cacheBlock[c] = blockOf[h];
+        return blockOf[h];
+    }
+
+    void Rehash()
+    {
+        keys.assign(keys.size() * 2, -1);
+        blockOf.assign(keys.size(), -1);
+        const size_t mask = keys.size() - 1;
+        for (int b = 0; b < NBlocks(); b++) {
+            size_t h = Hash(blockKey[b], mask);
+            while (keys[h] >= 0) h = (h + 1) & mask;
+            keys[h] = blockKey[b];
+            blockOf[h] = b;
+        }
+    }
+
+    //field f of cell, cell in the index space of the kind
+    double *Field(int block, int f) { return &pool[((size_t)block * nFields + f) * kBlock]; }
+
+    void Add(long cell, double w, double w2, double n)
+    {
+        const int b = Block(cell >> kBlockBits, true);
+        const int i = (int)(cell & (kBlock - 1));
+        Field(b, 0)[i] += w;
+        if (nFields > 1) Field(b, 1)[i] += w2;
+        if (nFields > 2) Field(b, 2)[i] += n;
+    }
+
+    //calls fn(cell - begin, field values) for every stored cell in [begin, end)
+    template <class Fn>
+    void ForEach(long begin, long end, Fn fn)
+    {
+        for (int b = 0; b < NBlocks(); b++) {
+            const long first = blockKey[b] << kBlockBits;
+            if (first >= end || first + kBlock <= begin) continue;
+            for (int i = 0; i < kBlock; i++) {
+                const long cell = first + i;
+                if (cell < begin || cell >= end) continue;
+                const double w = Field(b, 0)[i];
+                const double w2 = nFields > 1 ? Field(b, 1)[i] : 0.;
+                const double n = nFields > 2 ? Field(b, 2)[i] : 0.;
+                if (w != 0 || w2 != 0 || n != 0) fn(cell - begin, w, w2, n);
+            }
+        }
+    }
+};
+
+//________________________________________________________________________
+//Storage of every E3C histogram the task fills, in place of one TH3D per
+//(category, variant). Each family (kind, category) has one set of x, y, z
+//axes shared by its variants; the booked variants of one kind sit back to
+//back in a single array, each in the ROOT global-bin layout, so a variant
+//is an offset and a bin is ix + (nx+2)*(iy + (ny+2)*iz). The response kind
+//keeps Sumw2; the weight-axis kind is filled with unit weights and does not.
+//The moments kind is two-dimensional (no z axis, iz = 0) and keeps Sumw2
+//and the number of orderings per bin next to the summed weights.
+//A family is stored in double or, if single[kind][category], in float
+//arrays fed through the stage of its kind (8 instead of 16 bytes per bin
+//with Sumw2); in validation mode a single-precision family is kept in
+//both. A family with sparse[kind][category] (which takes precedence) only
+//stores its non-empty cells, in the E3CSparseStore of its kind, so finer
+//binning costs memory only where the fills land. Statistics and entries
+//are always double and are kept per histogram as TH3 (TH2 for the
+//moments) keeps them; Export writes one histogram into a TH3- or TH2-like
+//object at the end of the job, ExportSparse into a THnSparse-like one.
+struct E3CHistBank
+{
+    static constexpr int kNStats = 11; //TH3 statistics, see E3CJetAccumulator::AddToStats
+
+    static bool HasSumw2(int kind) { return kind != kE3CWeightAxis; }
+
+    E3CAxis axis[kE3CNKinds][kE3CNCategories][3];
+    bool booked[kE3CNKinds][kE3CNCategories][kE3CNVariants];
+    bool single[kE3CNKinds][kE3CNCategories];
+    bool sparse[kE3CNKinds][kE3CNCategories];
+    bool validate = false;
+    long offset[kE3CNKinds][kE3CNCategories][kE3CNVariants];  //first cell in content[kind], -1 if none
+    long offsetF[kE3CNKinds][kE3CNCategories][kE3CNVariants]; //first cell in contentF[kind], -1 if none
+    long offsetS[kE3CNKinds][kE3CNCategories][kE3CNVariants]; //first cell in sparseStore[kind], -1 if none
+    int slot[kE3CNKinds][kE3CNCategories][kE3CNVariants];     //index into stats/entries, -1 if not booked
+    std::vector<double> content[kE3CNKinds];
+    std::vector<double> sumw2[kE3CNKinds]; //response and moments, same offsets as content
+    std::vector<double> counts;            //moments: orderings per bin
+    std::vector<float> contentF[kE3CNKinds];
+    std::vector<float> sumw2F[kE3CNKinds];
+    std::vector<float> countsF;
+    E3CFloatStage stage[kE3CNKinds];
+    E3CSparseStore sparseStore[kE3CNKinds];
+    std::vector<double> stats;   //kNStats per slot
+    std::vector<double> entries; //per slot
+
+    //Where one histogram is filled: its double cells and/or, from offsetF,
+    //its float cells through the stage, or from offsetS its sparse cells
+    struct Target
+    {
+        double *content, *sumw2, *counts;
+        long offsetF;
+        long offsetS;
+    };
+
+    E3CHistBank() { Clear(); }
+
+    void Clear()
+    {
+        for (int k = 0; k < kE3CNKinds; k++) {
+            for (int c = 0; c < kE3CNCategories; c++) {
+                single[k][c] = sparse[k][c] = false;
+                for (int v = 0; v < kE3CNVariants; v++) {
+                    booked[k][c][v] = false;
+                    offset[k][c][v] = offsetF[k][c][v] = offsetS[k][c][v] = -1;
+                    slot[k][c][v] = -1;
+                }
+            }
+            content[k].clear(); sumw2[k].clear();
+            contentF[k].clear(); sumw2F[k].clear();
+            stage[k] = E3CFloatStage();
+            sparseStore[k].Reset(NFields(k));
+        }
+        validate = false;
+        counts.clear(); countsF.clear(); stats.clear(); entries.clear();
+    }
+
+    //Bin edges of family (kind, category): nx+1, ny+1, nz+1 ascending
+    //values; z = nullptr for the two-dimensional moments
+    template <class T>
+    void SetAxes(int kind, int category, int nx, const T *x, int ny, const T *y, int nz = 0, const T *z = nullptr)
+    {
+        const int n[3] = {nx, ny, nz};
+        const T *e[3] = {x, y, z};
+        for (int a = 0; a < 3; a++) {
+            std::vector<double> edges;
+            if (e[a]) edges.assign(e[a], e[a] + n[a] + 1);
+            axis[kind][category][a].SetEdges(edges);
+        }
+    }
+
+    void Book(int kind, int category, int variant) { booked[kind][category][variant] = true; }
+    bool Booked(int kind, int category, int variant) const { return booked[kind][category][variant]; }
+    void SetSingle(int kind, int category, bool on) { single[kind][category] = on; }
+    bool Single(int kind, int category) const { return single[kind][category]; }
+    void SetSparse(int kind, int category, bool on) { sparse[kind][category] = on; }
+    bool Sparse(int kind, int category) const { return sparse[kind][category]; }
+    static int NFields(int kind) { return kind == kE3CMoments ? 3 : (HasSumw2(kind) ? 2 : 1); }
+
+    //Lays out and zeroes the storage of everything booked; call once after SetAxes/Book/SetSingle/SetSparse
+    void Allocate()
+    {
+        int nSlots = 0;
+        for (int k = 0; k < kE3CNKinds; k++) {
+            long size = 0, sizeF = 0, sizeS = 0;
+            for (int c = 0; c < kE3CNCategories; c++) {
+                if (sparse[k][c]) single[k][c] = false;
+                for (int v = 0; v < kE3CNVariants; v++) {
+                    offset[k][c][v] = offsetF[k][c][v] = offsetS[k][c][v] = slot[k][c][v] = -1;
+                    if (!booked[k][c][v]) continue;
+                    slot[k][c][v] = nSlots++;
+                    if (sparse[k][c]) {
+                        offsetS[k][c][v] = sizeS;
+                        sizeS += NCells(k, c);
+                        continue;
+                    }
+                    if (!single[k][c] || validate) {
+                        offset[k][c][v] = size;
+                        size += NCells(k, c);
+                    }
+                    if (single[k][c]) {
+                        offsetF[k][c][v] = sizeF;
+                        sizeF += NCells(k, c);
+                    }
+                }
+            }
+            content[k].assign(size, 0.);
+            contentF[k].assign(sizeF, 0.f);
+            if (HasSumw2(k)) { sumw2[k].assign(size, 0.); sumw2F[k].assign(sizeF, 0.f); }
+            if (k == kE3CMoments) { counts.assign(size, 0.); countsF.assign(sizeF, 0.f); }
+            stage[k] = E3CFloatStage();
+            sparseStore[k].Reset(NFields(k));
+        }
+        stats.assign((size_t)nSlots * kNStats, 0.);
+        entries.assign(nSlots, 0.);
+    }
+
+    //-1 for the missing z axis of the moments, so that it counts as one cell
+    int NBins(int kind, int category, int a) const { return axis[kind][category][a].NBins(); }
+    long NCells(int kind, int category) const
+    {
+        return (long)(NBins(kind, category, 0) + 2) * (NBins(kind, category, 1) + 2) * (NBins(kind, category, 2) + 2);
+    }
+    long Bin(int kind, int category, int ix, int iy, int iz) const
+    {
+        return ix + (long)(NBins(kind, category, 0) + 2) * (iy + (long)(NBins(kind, category, 1) + 2) * iz);
+    }
+
+    double *Stats(int kind, int category, int variant) { return &stats[(size_t)slot[kind][category][variant] * kNStats]; }
+    double &Entries(int kind, int category, int variant) { return entries[slot[kind][category][variant]]; }
+
+    Target GetTarget(int kind, int category, int variant)
+    {
+        Target t{nullptr, nullptr, nullptr, offsetF[kind][category][variant], offsetS[kind][category][variant]};
+        const long off = offset[kind][category][variant];
+        if (off >= 0) {
+            t.content = &content[kind][off];
+            if (HasSumw2(kind)) t.sumw2 = &sumw2[kind][off];
+            if (kind == kE3CMoments) t.counts = &counts[off];
+        }
+        return t;
+    }
+
+    //w, w2 to the content and Sumw2 of one bin of t, n to its orderings
+    void Add(int kind, const Target &t, long bin, double w, double w2, double n)
+    {
+        if (t.content) {
+            t.content[bin] += w;
+            if (t.sumw2) t.sumw2[bin] += w2;
+            if (t.counts) t.counts[bin] += n;
+        }
+        if (t.offsetF >= 0 && stage[kind].Add(t.offsetF + bin, w, w2, n)) Drain(kind);
+        if (t.offsetS >= 0) sparseStore[kind].Add(t.offsetS + bin, w, w2, n);
+    }
+
+    void Drain(int kind)
+    {
+        stage[kind].Drain(contentF[kind].data(), HasSumw2(kind) ? sumw2F[kind].data() : nullptr,
+                          kind == kE3CMoments ? countsF.data() : nullptr);
+    }
+
+    //Empties every stage into the float bins
+    void Sync()
+    {
+        for (int k = 0; k < kE3CNKinds; k++) Drain(k);
+    }
+
+    //Copies one booked histogram into h, a TH3 (TH2 for the moments)
+    //booked with the axes of the family; TH3F/TH2F suit the single-precision
+    //families, whose float bins are exported also in validation mode
+    template <class H>
+    void Export(int kind, int category, int variant, H *h)
+    {
+        Sync();
+        const long n = NCells(kind, category);
+        if (sparse[kind][category]) {
+            auto *array = h->GetArray();
+            if (HasSumw2(kind)) h->Sumw2();
+            auto *array2 = HasSumw2(kind) ? h->GetSumw2()->fArray : nullptr;
+            const long off = offsetS[kind][category][variant];
+            sparseStore[kind].ForEach(off, off + n, [&](long bin, double w, double w2, double) {
+                array[bin] = w;
+                if (array2) array2[bin] = w2;
+            });
+            h->PutStats(&stats[(size_t)slot[kind][category][variant] * kNStats]);
+            h->SetEntries(entries[slot[kind][category][variant]]);
+            return;
+        }
+        const bool fromF = single[kind][category];
+        const long off = fromF ? offsetF[kind][category][variant] : offset[kind][category][variant];
+        if (fromF) std::copy(&contentF[kind][off], &contentF[kind][off] + n, h->GetArray());
+        else std::copy(&content[kind][off], &content[kind][off] + n, h->GetArray());
+        if (HasSumw2(kind)) {
+            h->Sumw2();
+            if (fromF) std::copy(&sumw2F[kind][off], &sumw2F[kind][off] + n, h->GetSumw2()->fArray);
+            else std::copy(&sumw2[kind][off], &sumw2[kind][off] + n, h->GetSumw2()->fArray);
+        }
+        h->PutStats(&stats[(size_t)slot[kind][category][variant] * kNStats]);
+        h->SetEntries(entries[slot[kind][category][variant]]);
+    }
+
+    //Orderings per bin of a moments histogram, into a TH2 with its axes
+    template <class H>
+    void ExportCounts(int category, int variant, H *h)
+    {
+        Sync();
+        const long n = NCells(kE3CMoments, category);
+        if (sparse[kE3CMoments][category]) {
+            auto *array = h->GetArray();
+            const long off = offsetS[kE3CMoments][category][variant];
+            sparseStore[kE3CMoments].ForEach(off, off + n, [&](long bin, double, double, double nOrd) { array[bin] = nOrd; });
+        }
+        else if (single[kE3CMoments][category]) {
+            const long off = offsetF[kE3CMoments][category][variant];
+            std::copy(&countsF[off], &countsF[off] + n, h->GetArray());
+        }
+        else {
+            const long off = offset[kE3CMoments][category][variant];
+            std::copy(&counts[off], &counts[off] + n, h->GetArray());
+        }
+        h->SetEntries(entries[slot[kE3CMoments][category][variant]]);
+    }
+
+    //Global bin of the family split into its axis bins, ROOT layout
+    void Coordinates(int kind, int category, long bin, int *idx) const
+    {
+        const long nx = NBins(kind, category, 0) + 2, ny = NBins(kind, category, 1) + 2;
+        idx[0] = (int)(bin % nx);
+        idx[1] = (int)((bin / nx) % ny);
+        idx[2] = (int)(bin / (nx * ny));
+    }
+
+    //Copies one booked histogram into hs, a THnSparse with the axes of the
+    //family (two for the moments, three otherwise), cell by non-empty cell;
+    //orderings = true writes the orderings of a moments histogram instead
+    template <class HS>
+    void ExportSparse(int kind, int category, int variant, HS *hs, bool orderings = false)
+    {
+        Sync();
+        const long n = NCells(kind, category);
+        if (HasSumw2(kind) && !orderings) hs->Sumw2();
+        auto fill = [&](long bin, double w, double w2, double nOrd) {
+            int idx[3];
+            Coordinates(kind, category, bin, idx);
+            const auto b = hs->GetBin(idx, true);
+            hs->SetBinContent(b, orderings ? nOrd : w);
+            if (HasSumw2(kind) && !orderings) hs->SetBinError2(b, w2);
+        };
+        const int s = slot[kind][category][variant];
+        if (sparse[kind][category]) {
+            const long off = offsetS[kind][category][variant];
+            sparseStore[kind].ForEach(off, off + n, fill);
+        }
+        else {
+            const Target t = GetTarget(kind, category, variant);
+            const long offF = offsetF[kind][category][variant];
+            for (long bin = 0; bin < n; bin++) {
+                double w, w2 = 0, nOrd = 0;
+                if (single[kind][category]) {
+                    w = contentF[kind][offF + bin];
+                    if (HasSumw2(kind)) w2 = sumw2F[kind][offF + bin];
+                    if (kind == kE3CMoments) nOrd = countsF[offF + bin];
+                }
+                else {
+                    w = t.content[bin];
+                    if (t.sumw2) w2 = t.sumw2[bin];
+                    if (t.counts) nOrd = t.counts[bin];
+                }
+                if (w != 0 || w2 != 0 || nOrd != 0) fill(bin, w, w2, nOrd);
+            }
+        }
+        hs->SetEntries(entries[s]);
+    }
+
+    //Frees the cells of one kind (double, float, stage and sparse store) once
+    //all its histograms are exported, so that export does not hold the bank
+    //and the ROOT copies at the same time. The kind cannot be filled or
+    //exported afterwards; bookings, statistics and entries are kept
+    void Release(int kind)
+    {
+        std::vector<double>().swap(content[kind]);
+        std::vector<double>().swap(sumw2[kind]);
+        std::vector<float>().swap(contentF[kind]);
+        std::vector<float>().swap(sumw2F[kind]);
+        if (kind == kE3CMoments) {
+            std::vector<double>().swap(counts);
+            std::vector<float>().swap(countsF);
+        }
+        stage[kind] = E3CFloatStage();
+        sparseStore[kind] = E3CSparseStore();
+        for (int c = 0; c < kE3CNCategories; c++)
+            for (int v = 0; v < kE3CNVariants; v++) offset[kind][c][v] = offsetF[kind][c][v] = offsetS[kind][c][v] = -1;
+    }
+
+    //Validation mode: largest |float - double| / |double| over the bins of
+    //one single-precision histogram (content, Sumw2 and orderings), -1 if
+    //there is no double copy to compare with
+    double MaxRelDeviation(int kind, int category, int variant)
+    {
+        const long off = offset[kind][category][variant];
+        const long offF = offsetF[kind][category][variant];
+        if (off < 0 || offF < 0) return -1;
+        Sync();
+        auto dev = [](double d, float f) { return d != 0 ? std::fabs((f - d) / d) : (f != 0 ? 1. : 0.); };
+        double worst = 0;
+        for (long i = 0; i < NCells(kind, category); i++) {
+            worst = std::max(worst, dev(content[kind][off + i], contentF[kind][offF + i]));
+            if (HasSumw2(kind)) worst = std::max(worst, dev(sumw2[kind][off + i], sumw2F[kind][offF + i]));
+            if (kind == kE3CMoments) worst = std::max(worst, dev(counts[off + i], countsF[offF + i]));
+        }
+        return worst;
+    }
+};
+
+//________________________________________________________________________
+//Per-call accumulator between the correlator loops and the histograms.
+//Terms are binned once, in R_L (response and moments families) and in
+//(R_L, weight) (weight-axis families), per category; x and y of every
+//target are fixed for the jet. Flush then adds each touched cell once
+//into every variant the jet goes to, keeping bin contents, Sumw2, entries
+//and the fill statistics identical to one TH3::Fill (TH2::Fill for the
+//moments) per term. All families of a kind must share the R_L and weight
+//binning of the first booked one.
+struct E3CJetAccumulator
+{
+    struct RLCell
+    {
+        double w, w2;     //reco weights
+        double wt, wt2;   //truth weights
+        int n;            //entries, 0 = untouched
+    };
+    struct RLStats
+    {
+        double entries;
+        double sw, sw2, swz, swz2;    //reco, in-range R_L only
+        double swt, swt2, swtz, swtz2; //truth
+    };
+    struct Stats3
+    {
+        double entries;
+        double n, sy, sy2, sz, sz2, syz; //in-range (R_L, weight) only
+    };
+
+    //Weighted sums per (category, R_L bin) and per category, for the
+    //response and the moments kinds
+    struct RLSums
+    {
+        E3CAxis rl;
+        int nRL = 0;                   //bins including under/overflow
+        std::vector<RLCell> cells;     //[category][R_L]
+        std::vector<int> touched;      //cell indices with a non-zero entry
+        RLStats stats[kE3CNCategories];
+        unsigned int used = 0;         //categories touched since the last flush
+
+        void Configure(const E3CAxis *axis)
+        {
+            if (axis) rl = *axis;
+            nRL = axis ? rl.NBins() + 2 : 0;
+            cells.assign((size_t)kE3CNCategories * nRL, RLCell{0, 0, 0, 0, 0});
+            touched.clear();
+            Reset();
+        }
+
+        //w, w2: summed weight and squared weights of the terms, entries their number
+        void Add(unsigned int mask, double RL, double w, double w2, double wt, double wt2, int entries)
+        {
+            const int bin = rl.Find(RL);
+            const bool in = rl.InRange(bin);
+            used |= mask;
+            while (mask) {
+                const int c = __builtin_ctz(mask);
+                mask &= mask - 1;
+                const int idx = c * nRL + bin;
+                RLCell &cell = cells[idx];
+                if (!cell.n) touched.push_back(idx);
+                cell.w += w; cell.w2 += w2; cell.wt += wt; cell.wt2 += wt2; cell.n += entries;
+                RLStats &s = stats[c];
+                s.entries += entries;
+                if (in) {
+                    s.sw += w; s.sw2 += w2; s.swz += w * RL; s.swz2 += w * RL * RL;
+                    s.swt += wt; s.swt2 += wt2; s.swtz += wt * RL; s.swtz2 += wt * RL * RL;
+                }
+            }
+        }
+
+        //adds the cells and statistics of o (same axis) and clears o
+        void Merge(RLSums &o)
+        {
+            for (int idx : o.touched) {
+                RLCell &cell = cells[idx];
+                const RLCell &add = o.cells[idx];
+                if (!cell.n) touched.push_back(idx);
+                cell.w += add.w; cell.w2 += add.w2; cell.wt += add.wt; cell.wt2 += add.wt2; cell.n += add.n;
+            }
+            for (unsigned int m = o.used; m; m &= m - 1) {
+                const int c = __builtin_ctz(m);
+                RLStats &s = stats[c];
+                const RLStats &a = o.stats[c];
+                s.entries += a.entries;
+                s.sw += a.sw; s.sw2 += a.sw2; s.swz += a.swz; s.swz2 += a.swz2;
+                s.swt += a.swt; s.swt2 += a.swt2; s.swtz += a.swtz; s.swtz2 += a.swtz2;
+            }
+            used |= o.used;
+            o.Reset();
+        }
+
+        //Touched cells and statistics kept aside (E3CConeCache); AddScaled
+        //adds them back for another normalisation, every weight scaling
+        //with norm (normTru for truth) and the squared ones with its square
+        struct Snapshot
+        {
+            std::vector<int> idx;
+            std::vector<RLCell> cells;
+            RLStats stats[kE3CNCategories];
+            unsigned int used = 0;
+        };
+
+        void Save(Snapshot &o) const
+        {
+            o.idx = touched;
+            o.cells.resize(touched.size());
+            for (size_t i = 0; i < touched.size(); i++) o.cells[i] = cells[touched[i]];
+            for (int c = 0; c < kE3CNCategories; c++) o.stats[c] = stats[c];
+            o.used = used;
+        }
+
+        void AddScaled(const Snapshot &o, double norm, double normTru)
+        {
+            const double norm2 = norm * norm, normTru2 = normTru * normTru;
+            for (size_t i = 0; i < o.idx.size(); i++) {
+                RLCell &cell = cells[o.idx[i]];
+                const RLCell &add = o.cells[i];
+                if (!cell.n) touched.push_back(o.idx[i]);
+                cell.w += add.w * norm; cell.w2 += add.w2 * norm2;
+                cell.wt += add.wt * normTru; cell.wt2 += add.wt2 * normTru2;
+                cell.n += add.n;
+            }
+            for (unsigned int m = o.used; m; m &= m - 1) {
+                const int c = __builtin_ctz(m);
+                RLStats &s = stats[c];
+                const RLStats &a = o.stats[c];
+                s.entries += a.entries;
+                s.sw += a.sw * norm; s.sw2 += a.sw2 * norm2; s.swz += a.swz * norm; s.swz2 += a.swz2 * norm;
+                s.swt += a.swt * normTru; s.swt2 += a.swt2 * normTru2; s.swtz += a.swtz * normTru; s.swtz2 += a.swtz2 * normTru;
+            }
+            used |= o.used;
+        }
+
+        void Reset()
+        {
+            for (int idx : touched) cells[idx] = RLCell{0, 0, 0, 0, 0};
+            touched.clear();
+            for (int c = 0; c < kE3CNCategories; c++) stats[c] = RLStats{0, 0, 0, 0, 0, 0, 0, 0, 0};
+            used = 0;
+        }
+    };
+
+    const void *configured = nullptr;
+    RLSums resp;  //response families, R_L axis of the first booked one
+    RLSums mom;   //moments families
+    E3CAxis rl3;  //R_L axis of the weight-axis families
+    E3CAxis wt3;  //their weight axis
+    int nRL3 = 0, nWt3 = 0; //bins including under/overflow
+
+    std::vector<int> cnt;           //[category][R_L][weight], reco
+    std::vector<int> cntTru;        //same for the truth weight
+    std::vector<int> touched3;      //cell indices with a non-zero entry
+    std::vector<int> touched3Tru;
+    Stats3 stats3[kE3CNCategories];
+    Stats3 stats3Tru[kE3CNCategories];
+    unsigned int used3 = 0;
+    //E3C_INSTRUMENT only
+    long filled = 0;          //terms given to a booked family
+    long flushes = 0;
+    double flushSeconds = 0;
+
+    void Configure(const E3CHistBank &bank)
+    {
+        configured = &bank;
+        int first[kE3CNKinds];
+        for (int k = 0; k < kE3CNKinds; k++) {
+            first[k] = -1;
+            for (int c = 0; c < kE3CNCategories && first[k] < 0; c++)
+                for (int v = 0; v < kE3CNVariants; v++)
+                    if (bank.Booked(k, c, v)) { first[k] = c; break; }
+        }
+        resp.Configure(first[kE3CResponse] >= 0 ? &bank.axis[kE3CResponse][first[kE3CResponse]][2] : nullptr);
+        mom.Configure(first[kE3CMoments] >= 0 ? &bank.axis[kE3CMoments][first[kE3CMoments]][1] : nullptr);
+        const int first3 = first[kE3CWeightAxis];
+        if (first3 >= 0) { rl3 = bank.axis[kE3CWeightAxis][first3][1]; wt3 = bank.axis[kE3CWeightAxis][first3][2]; }
+        nRL3 = first3 >= 0 ? rl3.NBins() + 2 : 0;
+        nWt3 = first3 >= 0 ? wt3.NBins() + 2 : 0;
+        cnt.assign((size_t)kE3CNCategories * nRL3 * nWt3, 0);
+        cntTru.assign(cnt.size(), 0);
+        touched3.clear(); touched3Tru.clear();
+        ResetStats3();
+    }
+
+    void ResetStats3()
+    {
+        for (int c = 0; c < kE3CNCategories; c++) stats3[c] = stats3Tru[c] = Stats3{0, 0, 0, 0, 0, 0, 0};
+        used3 = 0;
+    }
+
+    void AddResponse(unsigned int mask, double RL, double w, double w2, double wt, double wt2, int entries)
+    {
+        resp.Add(mask, RL, w, w2, wt, wt2, entries);
+    }
+
+    //w, w2: sum of the per-ordering weights and of their squares, count
+    //the number of orderings
+    void AddMoments(unsigned int mask, double RL, double w, double w2, double wt, double wt2, int count)
+    {
+        mom.Add(mask, RL, w, w2, wt, wt2, count);
+    }
+
+    //count unit-weight entries at (R_L, w3D) and, if truth, at (R_L, w3DTru)
+    void Add3D(unsigned int mask, double RL, double w3D, double w3DTru, bool truth, int count)
+    {
+        const int rbin = rl3.Find(RL);
+        const int wbin = wt3.Find(w3D);
+        const int wbinTru = truth ? wt3.Find(w3DTru) : 0;
+        const bool rin = rl3.InRange(rbin);
+        const bool in = rin && wt3.InRange(wbin);
+        const bool inTru = truth && rin && wt3.InRange(wbinTru);
+        used3 |= mask;
+        while (mask) {
+            const int c = __builtin_ctz(mask);
+            mask &= mask - 1;
+            const int idx = (c * nRL3 + rbin) * nWt3 + wbin;
+            if (!cnt[idx]) touched3.push_back(idx);
+            cnt[idx] += count;
+            AddStats3(stats3[c], in, RL, w3D, count);
+            if (truth) {
+                const int idxTru = (c * nRL3 + rbin) * nWt3 + wbinTru;
+                if (!cntTru[idxTru]) touched3Tru.push_back(idxTru);
+                cntTru[idxTru] += count;
+                AddStats3(stats3Tru[c], inTru, RL, w3DTru, count);
+            }
+        }
+    }
+
+    //Adds what o collected (an accumulator configured from the same bank)
+    //and clears it, for the tiles of a split call (E3CParallel)
+    void Merge(E3CJetAccumulator &o)
+    {
+        resp.Merge(o.resp);
+        mom.Merge(o.mom);
+        for (int idx : o.touched3) {
+            if (!cnt[idx]) touched3.push_back(idx);
+            cnt[idx] += o.cnt[idx];
+            o.cnt[idx] = 0;
+        }
+        for (int idx : o.touched3Tru) {
+            if (!cntTru[idx]) touched3Tru.push_back(idx);
+            cntTru[idx] += o.cntTru[idx];
+            o.cntTru[idx] = 0;
+        }
+        o.touched3.clear(); o.touched3Tru.clear();
+        for (unsigned int m = o.used3; m; m &= m - 1) {
+            const int c = __builtin_ctz(m);
+            Stats3 *dst[2] = {&stats3[c], &stats3Tru[c]};
+            const Stats3 *src[2] = {&o.stats3[c], &o.stats3Tru[c]};
+            for (int t = 0; t < 2; t++) {
+                dst[t]->entries += src[t]->entries;
+                dst[t]->n += src[t]->n; dst[t]->sy += src[t]->sy; dst[t]->sy2 += src[t]->sy2;
+                dst[t]->sz += src[t]->sz; dst[t]->sz2 += src[t]->sz2; dst[t]->syz += src[t]->syz;
+            }
+        }
+        used3 |= o.used3;
+        o.ResetStats3();
+    }
+
+    static void AddStats3(Stats3 &s, bool in, double y, double z, int count)
+    {
+        s.entries += count;
+        if (!in) return;
+        s.n += count; s.sy += count * y; s.sy2 += count * y * y;
+        s.sz += count * z; s.sz2 += count * z * z; s.syz += count * y * z;
+    }
+
+    //Adds everything collected since the last flush to the variants of the
+    //jet and clears the touched cells. Layout and booking come from bank,
+    //the cells go to out: the bank itself, or an E3CFlushRecord replayed
+    //into it later
+    template <bool Matched, bool CFactor>
+    void Flush(E3CHistBank &bank, double jetpt, double pt) { Flush<Matched, CFactor>(bank, bank, jetpt, pt); }
+
+    //keep leaves the sums in place, to be flushed again with more terms
+    //(nested cones)
+    template <bool Matched, bool CFactor, class Out>
+    void Flush(const E3CHistBank &bank, Out &out, double jetpt, double pt, bool keep = false)
+    {
+        E3C_INSTR(const E3CScopedSum timer(flushSeconds); flushes++;)
+        const int kReco = Matched ? (CFactor ? kE3CCM : kE3CM) : (CFactor ? kE3CCUM : kE3CUM);
+        const int kTru = CFactor ? kE3CTruCM : kE3CTruM;
+        const int variants[3] = {kE3CIncl, kReco, kTru};
+        const int nVariants = Matched ? 3 : 2;
+
+        for (int t = 0; t < nVariants; t++) {
+            const bool tru = (t == 2);
+            const int v = variants[t];
+
+            //response: (jetpt, pt, R_L), the truth variant with the truth weights
+            for (unsigned int m = resp.used; m; m &= m - 1) {
+                const int c = __builtin_ctz(m);
+                if (!bank.Booked(kE3CResponse, c, v)) continue;
+                const E3CAxis *ax = bank.axis[kE3CResponse][c];
+                const int ix = ax[0].Find(jetpt);
+                const int iy = ax[1].Find(pt);
+                //global bin = base + R_L bin * stride, (ix, iy) fixed for the jet
+                FlushRL(out, kE3CResponse, c, v, resp, tru, bank.Bin(kE3CResponse, c, ix, iy, 0), bank.Bin(kE3CResponse, c, 0, 0, 1));
+                const RLStats &s = resp.stats[c];
+                if (ax[0].InRange(ix) && ax[1].InRange(iy)) {
+                    const double sw = tru ? s.swt : s.sw, sw2 = tru ? s.swt2 : s.sw2;
+                    const double swz = tru ? s.swtz : s.swz, swz2 = tru ? s.swtz2 : s.swz2;
+                    const double add[11] = {sw, sw2, sw * jetpt, sw * jetpt * jetpt, sw * pt, sw * pt * pt,
+                                            sw * jetpt * pt, swz, swz2, swz * jetpt, swz * pt};
+                    AddToStats(out.Stats(kE3CResponse, c, v), add);
+                }
+            }
+
+            //moments: (x, R_L) with x = jetpt, or pt for the truth variant
+            const double x = tru ? pt : jetpt;
+            for (unsigned int m = mom.used; m; m &= m - 1) {
+                const int c = __builtin_ctz(m);
+                if (!bank.Booked(kE3CMoments, c, v)) continue;
+                const E3CAxis &ax = bank.axis[kE3CMoments][c][0];
+                const int ix = ax.Find(x);
+                FlushRL(out, kE3CMoments, c, v, mom, tru, bank.Bin(kE3CMoments, c, ix, 0, 0), bank.Bin(kE3CMoments, c, 0, 1, 0));
+                const RLStats &s = mom.stats[c];
+                if (ax.InRange(ix)) {
+                    const double sw = tru ? s.swt : s.sw, sw2 = tru ? s.swt2 : s.sw2;
+                    const double swy = tru ? s.swtz : s.swz, swy2 = tru ? s.swtz2 : s.swz2;
+                    const double add[11] = {sw, sw2, sw * x, sw * x * x, swy, swy2, swy * x, 0, 0, 0, 0};
+                    AddToStats(out.Stats(kE3CMoments, c, v), add);
+                }
+            }
+
+            //weight-axis: (x, R_L, w)
+            const std::vector<int> &counts = tru ? cntTru : cnt;
+            const std::vector<int> &touched = tru ? touched3Tru : touched3;
+            for (unsigned int m = used3; m; m &= m - 1) {
+                const int c = __builtin_ctz(m);
+                if (!bank.Booked(kE3CWeightAxis, c, v)) continue;
+                const E3CAxis &ax = bank.axis[kE3CWeightAxis][c][0];
+                const int ix = ax.Find(x);
+                const auto target = out.GetTarget(kE3CWeightAxis, c, v);
+                const long base = bank.Bin(kE3CWeightAxis, c, ix, 0, 0);
+                const long strideY = bank.Bin(kE3CWeightAxis, c, 0, 1, 0);
+                const long strideZ = bank.Bin(kE3CWeightAxis, c, 0, 0, 1);
+                for (int idx : touched) {
+                    if (idx / (nRL3 * nWt3) != c) continue;
+                    const long bin = base + ((idx / nWt3) % nRL3) * strideY + (idx % nWt3) * strideZ;
+                    out.Add(kE3CWeightAxis, target, bin, counts[idx], 0, 0);
+                }
+                const Stats3 &s = tru ? stats3Tru[c] : stats3[c];
+                if (ax.InRange(ix)) {
+                    const double add[11] = {s.n, s.n, s.n * x, s.n * x * x, s.sy, s.sy2,
+                                            s.sy * x, s.sz, s.sz2, s.sz * x, s.syz};
+                    AddToStats(out.Stats(kE3CWeightAxis, c, v), add);
+                }
+                out.Entries(kE3CWeightAxis, c, v) += s.entries;
+            }
+        }
+
+        if (keep) return;
+        resp.Reset();
+        mom.Reset();
+        for (int idx : touched3) cnt[idx] = 0;
+        for (int idx : touched3Tru) cntTru[idx] = 0;
+        touched3.clear(); touched3Tru.clear();
+        ResetStats3();
+    }
+
+    //Adds the R_L cells of category c to variant v at base + R_L bin * stride,
+    //with the orderings per bin for the moments
+    template <class Out>
+    static void FlushRL(Out &out, int kind, int c, int v, const RLSums &sums, bool tru, long base, long stride)
+    {
+        const auto target = out.GetTarget(kind, c, v);
+        for (int idx : sums.touched) {
+            if (idx / sums.nRL != c) continue;
+            const RLCell &cell = sums.cells[idx];
+            const long bin = base + (idx % sums.nRL) * stride;
+            out.Add(kind, target, bin, tru ? cell.wt : cell.w, tru ? cell.wt2 : cell.w2, cell.n);
+        }
+        out.Entries(kind, c, v) += sums.stats[c].entries;
+    }
+
+    //TH3 statistics: sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwxy, sumwz, sumwz2, sumwxz, sumwyz
+    //(the first seven for TH2)
+    static void AddToStats(double *stats, const double *add)
+    {
+        for (int i = 0; i < E3CHistBank::kNStats; i++) stats[i] += add[i];
+    }
+};
+
+//Routes one correlator term into the per-call accumulator; Matched and
+//CFactor are fixed per jet so the choice is made at compile time
+template <bool Matched, bool CFactor>
+struct E3CHistSink
+{
+    static constexpr int kReco = Matched ? (CFactor ? kE3CCM : kE3CM) : (CFactor ? kE3CCUM : kE3CUM);
+    static constexpr int kTru = CFactor ? kE3CTruCM : kE3CTruM;
+
+    E3CJetAccumulator &acc;
+    unsigned int enabled4; //categories with a response histogram for this jet
+    unsigned int enabled3; //categories with a weight-axis histogram for this jet
+    unsigned int enabledM; //categories with a moments histogram for this jet
+    unsigned int enabled;
+
+    E3CHistSink(const E3CHistBank &bank, E3CJetAccumulator &accIn)
+        : acc(accIn), enabled4(0), enabled3(0), enabledM(0), enabled(0)
+    {
+        if (acc.configured != &bank) acc.Configure(bank);
+        unsigned int *masks[kE3CNKinds] = {&enabled4, &enabled3, &enabledM};
+        for (int k = 0; k < kE3CNKinds; k++)
+            for (int c = 0; c < kE3CNCategories; c++)
+                if (bank.Booked(k, c, kE3CIncl) || bank.Booked(k, c, kReco) || (Matched && bank.Booked(k, c, kTru))) *masks[k] |= E3CBit(c);
+        enabled = enabled4 | enabled3 | enabledM;
+    }
+
+    //w3D/w3DTru are the weights of one ordering, nperm the number of orderings
+    void Fill(unsigned int mask, double RL, double w3D, double w3DTru, int nperm) const
+    {
+        const double w = nperm * w3D;
+        const double wt = nperm * w3DTru;
+        E3C_INSTR(if (mask & enabled) acc.filled++;)
+        FillResponse(mask, RL, w, w * w, wt, wt * wt, 1);
+        FillMoments(mask, RL, w, w * w3D, wt, wt * w3DTru, nperm);
+        Fill3D(mask, RL, w3D, w3DTru, nperm);
+    }
+
+    //(jetpt, pt, R_L) families only; w, w2 sum the full weights of the
+    //entries terms (orderings included) and their squares
+    void FillResponse(unsigned int mask, double RL, double w, double w2, double wt, double wt2, int entries) const
+    {
+        mask &= enabled4;
+        if (mask) acc.AddResponse(mask, RL, w, w2, wt, wt2, entries);
+    }
+
+    //(x, R_L) moments; w, w2 sum the per-ordering weights and their
+    //squares over count orderings
+    void FillMoments(unsigned int mask, double RL, double w, double w2, double wt, double wt2, int count) const
+    {
+        mask &= enabledM;
+        if (mask) acc.AddMoments(mask, RL, w, w2, wt, wt2, count);
+    }
+
+    //(x, R_L, weight) families, one unit entry per ordering
+    void Fill3D(unsigned int mask, double RL, double w3D, double w3DTru, int nperm) const
+    {
+        mask &= enabled3;
+        if (mask) acc.Add3D(mask, RL, w3D, w3DTru, Matched, nperm);
+    }
+};
+
+//Particle list regrouped by origin code: bucket q = E3CCodeIndex(cat)
+//holds the entries [begin[q], begin[q+1]) of block, in input order
+struct E3CBuckets
+{
+    E3CParticleBlock block;
+    int begin[kE3CNCodes + 1];
+
+    int Begin(int q) const { return begin[q]; }
+    int End(int q) const { return begin[q + 1]; }
+    bool Empty(int q) const { return begin[q] == begin[q + 1]; }
+
+    void Build(const E3CParticleBlock &src)
+    {
+        const int n = src.Size();
+        int next[kE3CNCodes] = {0};
+        for (int i = 0; i < n; i++) next[E3CCodeIndex(src.cat[i])]++;
+        begin[0] = 0;
+        for (int q = 0; q < kE3CNCodes; q++) {
+            begin[q + 1] = begin[q] + next[q];
+            next[q] = begin[q];
+        }
+        block.pt.resize(n); block.eta.resize(n); block.phi.resize(n); block.cat.resize(n);
+        for (int i = 0; i < n; i++) {
+            const int d = next[E3CCodeIndex(src.cat[i])]++;
+            block.pt[d] = src.pt[i];
+            block.eta[d] = src.eta[i];
+            block.phi[d] = src.phi[i];
+            block.cat[d] = src.cat[i];
+        }
+    }
+};
+
+//________________________________________________________________________
+//Storage of the sorted-pair engine (E3CEnumerateSorted). The lists of a
+//call are concatenated into one vertex range; adj holds one bitset row
+//per vertex, byteSum/byteSum2 the sum of pT/pT^2 over every subset of
+//each 8-vertex chunk.
+struct E3CSortedPair
+{
+    double dR;
+    int u;
+    int v;
+
+    bool operator<(const E3CSortedPair &o) const { return dR < o.dR; }
+};
+
+struct E3CSortedWork
+{
+    int nWords = 0;
+    std::vector<uint64_t> adj;
+    std::vector<uint64_t> common;
+    std::vector<double> byteSum;
+    std::vector<double> byteSum2;
+    std::vector<E3CSortedPair> pairs;
+
+    void Reset(int n)
+    {
+        nWords = (n + 63) / 64;
+        adj.assign((size_t)n * nWords, 0);
+        common.resize(nWords);
+        byteSum.resize((size_t)nWords * 8 * 256);
+        byteSum2.resize(byteSum.size());
+        pairs.clear();
+    }
+
+    void BuildByteSums(const double *pt, int n)
+    {
+        for (int chunk = 0; chunk < nWords * 8; chunk++) {
+            double *tab = &byteSum[(size_t)chunk * 256];
+            double *tab2 = &byteSum2[(size_t)chunk * 256];
+            tab[0] = tab2[0] = 0;
+            for (int b = 0; b < 8; b++) {
+                const int k = chunk * 8 + b;
+                const double p = (k < n) ? pt[k] : 0.;
+                for (int s = 0; s < (1 << b); s++) {
+                    tab[s | (1 << b)] = tab[s] + p;
+                    tab2[s | (1 << b)] = tab2[s] + p * p;
+                }
+            }
+        }
+    }
+
+    //common = adj(u) & adj(v) restricted to [lo, hi); returns false if empty
+    bool Common(int u, int v, int lo, int hi)
+    {
+        const uint64_t *au = &adj[(size_t)u * nWords];
+        const uint64_t *av = &adj[(size_t)v * nWords];
+        uint64_t any = 0;
+        const int w0 = lo >> 6;
+        const int w1 = (hi - 1) >> 6;
+        for (int w = w0; w <= w1; w++) {
+            uint64_t m = au[w] & av[w];
+            if (w == w0) m &= ~uint64_t(0) << (lo & 63);
+            if (w == w1 && (hi & 63)) m &= ~uint64_t(0) >> (64 - (hi & 63));
+            common[w] = m;
+            any |= m;
+        }
+        return any != 0;
+    }
+
+    //sum of pT and pT^2 over common, and its size
+    void CommonPtSums(int lo, int hi, double &sum, double &sum2, int &count) const
+    {
+        sum = sum2 = 0;
+        count = 0;
+        for (int w = lo >> 6; w <= ((hi - 1) >> 6); w++) {
+            uint64_t m = common[w];
+            count += __builtin_popcountll(m);
+            for (int b = 0; m; b++, m >>= 8) {
+                const size_t t = ((size_t)w * 8 + b) * 256 + (m & 0xff);
+                sum += byteSum[t];
+                sum2 += byteSum2[t];
+            }
+        }
+    }
+
+    void Link(int u, int v)
+    {
+        adj[(size_t)u * nWords + (v >> 6)] |= uint64_t(1) << (v & 63);
+        adj[(size_t)v * nWords + (u >> 6)] |= uint64_t(1) << (u & 63);
+    }
+};
+
+//Bucketed copies, pair caches and kernel scratch, reused from jet to jet
+struct E3CWorkspace
+{
+    E3CBuckets partA;  //particles
+    E3CBuckets partB;  //particles2
+    E3CBuckets partC;  //particles3
+    E3CPairCache same; //within particles (single list) or particles2 (two)
+    E3CPairCache ab;   //particles x particles2
+    E3CPairCache bc;   //particles2 x particles3
+    E3CPairCache ac;   //particles x particles3
+    E3CTripletScratch trip;
+    E3CJetAccumulator acc;
+    E3CJetAccumulator enc[kE3CMaxOrder + 1]; //per order, E3CComputeENC
+    E3CSortedWork sorted;
+    std::vector<double> vPt;          //concatenated lists for the sorted-pair engine
+    std::vector<double> vEta;
+    std::vector<double> vPhi;
+    std::vector<signed char> vCode;
+};
+
+//E3C_INSTRUMENT counters summed over workspaces and accumulators
+struct E3CCounters
+{
+    long evaluated = 0;
+    long filled = 0;
+    long flushes = 0;
+    double flushSeconds = 0;
+
+    void Add(const E3CJetAccumulator &acc)
+    {
+        filled += acc.filled;
+        flushes += acc.flushes;
+        flushSeconds += acc.flushSeconds;
+    }
+    void Add(const E3CWorkspace &ws)
+    {
+        evaluated += ws.trip.evaluated;
+        Add(ws.acc);
+        for (const E3CJetAccumulator &acc : ws.enc) Add(acc);
+    }
+};
+
+inline int E3CCodeTriple(int qa, int qb, int qc) { return (qa * kE3CNCodes + qb) * kE3CNCodes + qc; }
+
+//Triplet enumeration for one mode over origin-bucket combinations; only
+//combinations with an enabled category are visited, so the category mask
+//is fixed inside the particle loops. Orderings: 3 for the coincident
+//i,j,j / i,i,j terms, 6 for distinct triplets.
+//norm = 1/jetpt^3, normTru = 1/pt^3
+//E3CPrepare buckets the lists and builds the pair caches in ws;
+//E3CEnumerateRange then only reads them, for the particles i in
+//[iBegin, iEnd) of the bucketed list a, so disjoint i ranges can run on
+//different threads with their own scratch and sink (E3CParallel).
+template <E3CMode Mode>
+void E3CPrepare(const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c, E3CWorkspace &ws)
+{
+    const bool single = E3CSingleList(Mode);
+    const bool diff = (Mode == kE3CAllDiff);
+
+    ws.partA.Build(a);
+    if (!single) ws.partB.Build(b);
+    if (diff) ws.partC.Build(c);
+    const E3CBuckets &A = ws.partA;
+    const E3CBuckets &B = single ? ws.partA : ws.partB;
+    const E3CBuckets &C = diff ? ws.partC : B;
+
+    if (single) ws.same.BuildSame(A.block);
+    else ws.ab.BuildCross(A.block, B.block);
+    if (Mode == kE3CTwo) ws.same.BuildSame(B.block);
+    if (diff) {
+        ws.bc.BuildCross(B.block, C.block);
+        ws.ac.BuildCross(A.block, C.block);
+    }
+}
+
+//jBegin/jEnd and kBegin/kEnd restrict j and k in the same way (nested
+//cones, E3CComputeNested)
+template <E3CMode Mode, class Sink>
+void E3CEnumerateRange(const E3CWorkspace &ws, int iBegin, int iEnd, double norm, double normTru,
+                       E3CTripletScratch &trip, const Sink &sink,
+                       int jBegin = 0, int jEnd = INT_MAX, int kBegin = 0, int kEnd = INT_MAX)
+{
+    //single list: i<j<k over one list, bucket combinations qa<=qb<=qc
+    //two: i from a, j<k from b, qb<=qc; all-diff: every (qa,qb,qc)
+    const bool single = E3CSingleList(Mode);
+    const bool diff = (Mode == kE3CAllDiff);
+    const E3CBuckets &A = ws.partA;
+    const E3CBuckets &B = single ? ws.partA : ws.partB;
+    const E3CBuckets &C = diff ? ws.partC : B;
+    const E3CPairCache &pij = single ? ws.same : ws.ab;
+    const E3CPairCache &pjk = diff ? ws.bc : ws.same;
+    const E3CPairCache &pik = single ? ws.same : (diff ? ws.ac : ws.ab);
+
+    const unsigned int *lut = E3CCategoryLUT::mask[Mode];
+    const unsigned int enabled = sink.enabled;
+
+    E3CTripletInput in;
+    in.norm = norm;
+    in.normTru = normTru;
+
+    for (int qa = 0; qa < kE3CNCodes; qa++) {
+        if (A.Empty(qa) || A.End(qa) <= iBegin || A.Begin(qa) >= iEnd) continue;
+        for (int qb = single ? qa : 0; qb < kE3CNCodes; qb++) {
+            if (B.Empty(qb)) continue;
+
+            //coincident terms
+            const unsigned int mijj = diff ? 0 : (lut[E3CCodeTriple(qa, qb, qb)] & enabled);
+            const unsigned int miij = single ? (lut[E3CCodeTriple(qa, qa, qb)] & enabled) : 0;
+            if (mijj || miij) {
+                for (int i = std::max(A.Begin(qa), iBegin); i < std::min(A.End(qa), iEnd); i++) {
+                    for (int j = std::max(single ? std::max(B.Begin(qb), i + 1) : B.Begin(qb), jBegin); j < std::min(B.End(qb), jEnd); j++) {
+                        const double dRij = pij.DeltaR(i, j);
+                        const double ptij = pij.PtProd(i, j);
+                        E3C_INSTR(trip.evaluated++;)
+                        if (mijj) {
+                            const double w = ptij * B.block.pt[j];
+                            sink.Fill(mijj, dRij, w * norm, w * normTru, 3);
+                        }
+                        if (miij) {
+                            const double w = ptij * A.block.pt[i];
+                            sink.Fill(miij, dRij, w * norm, w * normTru, 3);
+                        }
+                    }
+                }
+            }
+
+            //distinct triplets
+            for (int qc = diff ? 0 : qb; qc < kE3CNCodes; qc++) {
+                if (C.Empty(qc)) continue;
+                const unsigned int mask = lut[E3CCodeTriple(qa, qb, qc)] & enabled;
+                if (!mask) continue;
+                for (int i = std::max(A.Begin(qa), iBegin); i < std::min(A.End(qa), iEnd); i++) {
+                    for (int j = std::max(single ? std::max(B.Begin(qb), i + 1) : B.Begin(qb), jBegin); j < std::min(B.End(qb), jEnd); j++) {
+                        const int k0 = std::max(diff ? C.Begin(qc) : std::max(C.Begin(qc), j + 1), kBegin);
+                        const int k1 = std::min(C.End(qc), kEnd);
+                        if (k0 >= k1) continue;
+                        in.dRjk = pjk.DeltaRRow(j, k0);
+                        in.dRik = pik.DeltaRRow(i, k0);
+                        in.ptk = &C.block.pt[k0];
+                        in.n = k1 - k0;
+                        in.dRij = pij.DeltaR(i, j);
+                        in.ptij = pij.PtProd(i, j);
+                        E3CTripletKernel(in, trip);
+                        E3C_INSTR(trip.evaluated += in.n;)
+                        for (int t = 0; t < in.n; t++)
+                            sink.Fill(mask, trip.RL[t], trip.w3D[t], trip.w3DTru[t], 6);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <E3CMode Mode, class Sink>
+void E3CEnumerate(const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                  double norm, double normTru, E3CWorkspace &ws, const Sink &sink)
+{
+    E3CPrepare<Mode>(a, b, c, ws);
+    E3CEnumerateRange<Mode>(ws, 0, ws.partA.block.Size(), norm, normTru, ws.trip, sink);
+}
+
+//Exact alternative to E3CEnumerate with the same output. All pairs are
+//visited in ascending Delta R; a pair is then the longest side of every
+//triangle it closes with common neighbours visited before it, so its
+//third-particle pT sum per origin bucket is one bitset AND plus byte
+//table lookups and the response and moments families get one fill per
+//pair instead of one per triplet. Cost: O(N^2 log N) for the sort plus
+//N/64 words per pair; weight-axis families still need the individual
+//third particles.
+template <E3CMode Mode, class Sink>
+void E3CEnumerateSorted(const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                        double norm, double normTru, E3CWorkspace &ws, const Sink &sink)
+{
+    const bool single = E3CSingleList(Mode);
+    const bool diff = (Mode == kE3CAllDiff);
+    const int nLists = single ? 1 : (diff ? 3 : 2);
+
+    //vertex ranges: list l, bucket q -> [offset[l] + Begin(q), offset[l] + End(q))
+    ws.partA.Build(a);
+    if (!single) ws.partB.Build(b);
+    if (diff) ws.partC.Build(c);
+    const E3CBuckets *lists[3] = {&ws.partA, &ws.partB, &ws.partC};
+    int offset[4] = {0, 0, 0, 0};
+    for (int l = 0; l < nLists; l++) offset[l + 1] = offset[l] + lists[l]->block.Size();
+    const int n = offset[nLists];
+    if (n < 2) return;
+
+    ws.vPt.resize(n); ws.vEta.resize(n); ws.vPhi.resize(n); ws.vCode.resize(n);
+    for (int l = 0; l < nLists; l++) {
+        const E3CParticleBlock &blk = lists[l]->block;
+        for (int i = 0; i < blk.Size(); i++) {
+            ws.vPt[offset[l] + i] = blk.pt[i];
+            ws.vEta[offset[l] + i] = blk.eta[i];
+            ws.vPhi[offset[l] + i] = blk.phi[i];
+            ws.vCode[offset[l] + i] = (signed char)E3CCodeIndex(blk.cat[i]);
+        }
+    }
+    auto listOf = [&](int u) { return (u >= offset[1]) + (nLists > 2 && u >= offset[2]); };
+
+    //edges: all pairs of one list; a-b and b-b for two; a-b, b-c, a-c for all-diff
+    E3CSortedWork &sw = ws.sorted;
+    sw.Reset(n);
+    for (int u = 0; u < n; u++) {
+        const int lu = listOf(u);
+        for (int v = u + 1; v < n; v++) {
+            const int lv = listOf(v);
+            if (!single && lu == lv && !(Mode == kE3CTwo && lu == 1)) continue;
+            double dphi = std::fabs(ws.vPhi[u] - ws.vPhi[v]);
+            if (dphi > M_PI) dphi = 2. * M_PI - dphi;
+            const double deta = ws.vEta[u] - ws.vEta[v];
+            sw.pairs.push_back({std::sqrt(dphi * dphi + deta * deta), u, v});
+        }
+    }
+    std::sort(sw.pairs.begin(), sw.pairs.end());
+    sw.BuildByteSums(ws.vPt.data(), n);
+
+    const unsigned int *lut = E3CCategoryLUT::mask[Mode];
+    const unsigned int enabled = sink.enabled;
+
+    for (const E3CSortedPair &p : sw.pairs) {
+        const int u = p.u;
+        const int v = p.v;
+        const int lu = listOf(u);
+        const int lv = listOf(v);
+        const int cu = ws.vCode[u];
+        const int cv = ws.vCode[v];
+        const double ptuv = ws.vPt[u] * ws.vPt[v];
+        E3C_INSTR(ws.trip.evaluated++;)
+
+        //coincident terms; for two only the a-b pairs, a first
+        if (single) {
+            const unsigned int mijj = lut[E3CCodeTriple(cu, cv, cv)] & enabled;
+            const unsigned int miij = lut[E3CCodeTriple(cu, cu, cv)] & enabled;
+            if (mijj) sink.Fill(mijj, p.dR, ptuv * ws.vPt[v] * norm, ptuv * ws.vPt[v] * normTru, 3);
+            if (miij) sink.Fill(miij, p.dR, ptuv * ws.vPt[u] * norm, ptuv * ws.vPt[u] * normTru, 3);
+        }
+        else if (Mode == kE3CTwo && lu != lv) {
+            const unsigned int mijj = lut[E3CCodeTriple(cu, cv, cv)] & enabled;
+            if (mijj) sink.Fill(mijj, p.dR, ptuv * ws.vPt[v] * norm, ptuv * ws.vPt[v] * normTru, 3);
+        }
+
+        //triangles closed by (u,v): third vertex from the remaining list
+        int lw = 0;
+        if (Mode == kE3CTwo) lw = (lu == lv) ? 0 : 1;
+        if (diff) lw = 3 - lu - lv;
+        const E3CBuckets &W = *lists[lw];
+        for (int q = 0; q < kE3CNCodes; q++) {
+            if (W.Empty(q)) continue;
+            //codes in list order, as the lookup table expects; the two
+            //particles of list b in ascending bucket order for two
+            int code[3] = {cu, cv, q};
+            if (Mode == kE3CTwo) {
+                const int qa = (lw == 0) ? q : cu;
+                const int qb = (lw == 0) ? cu : cv;
+                const int qc = (lw == 0) ? cv : q;
+                code[0] = qa;
+                code[1] = std::min(qb, qc);
+                code[2] = std::max(qb, qc);
+            }
+            else if (diff) {
+                code[lu] = cu;
+                code[lv] = cv;
+                code[lw] = q;
+            }
+            const unsigned int mask = lut[E3CCodeTriple(code[0], code[1], code[2])] & enabled;
+            if (!mask) continue;
+            const int lo = offset[lw] + W.Begin(q);
+            const int hi = offset[lw] + W.End(q);
+            if (!sw.Common(u, v, lo, hi)) continue;
+            if (mask & (sink.enabled4 | sink.enabledM)) {
+                double sum, sum2;
+                int count;
+                sw.CommonPtSums(lo, hi, sum, sum2, count);
+                E3C_INSTR(ws.acc.filled += count;)
+                //6 orderings per triplet; squares summed per triplet for Sumw2
+                //of the response, per ordering for the moments
+                const double w = 6 * ptuv * sum, w2 = 36 * ptuv * ptuv * sum2;
+                sink.FillResponse(mask, p.dR, w * norm, w2 * norm * norm, w * normTru, w2 * normTru * normTru, count);
+                sink.FillMoments(mask, p.dR, w * norm, w2 / 6 * norm * norm, w * normTru, w2 / 6 * normTru * normTru, 6 * count);
+            }
+            if (mask & sink.enabled3) {
+                for (int w = lo >> 6; w <= ((hi - 1) >> 6); w++) {
+                    for (uint64_t m = sw.common[w]; m; m &= m - 1) {
+                        const double wk = ptuv * ws.vPt[w * 64 + __builtin_ctzll(m)];
+                        E3C_INSTR(if (!(mask & (sink.enabled4 | sink.enabledM))) ws.acc.filled++;)
+                        sink.Fill3D(mask, p.dR, wk * norm, wk * normTru, 6);
+                    }
+                }
+            }
+        }
+        sw.Link(u, v);
+    }
+}
+
+//Which algorithm ComputeE3C runs; both give the same histograms
+enum E3CEngine
+{
+    kE3CEngineTriplet = 0, //bucketed triplet loop with the vectorised k kernel
+    kE3CEngineSortedPairs, //ascending-Delta R pair sweep with bitset neighbour sums
+    kE3CNEngines,
+    kE3CEngineAuto = -1    //chosen per call by E3CDispatcher
+};
+
+//out: the bank, or an E3CFlushRecord of the call (see E3CParallel)
+//Terms of one call into ws.acc, not flushed; false if nothing is booked
+//for this (matched, cfactor)
+template <bool Matched, bool CFactor>
+bool E3CAccumulate(E3CMode mode, E3CEngine engine, const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                   double norm, double normTru, E3CWorkspace &ws, const E3CHistBank &bank)
+{
+    const E3CHistSink<Matched, CFactor> sink(bank, ws.acc);
+    if (!sink.enabled) return false;
+    if (engine == kE3CEngineSortedPairs) {
+        switch (mode) {
+            case kE3CSameJet: E3CEnumerateSorted<kE3CSameJet>(a, b, c, norm, normTru, ws, sink); break;
+            case kE3CSameMB: E3CEnumerateSorted<kE3CSameMB>(a, b, c, norm, normTru, ws, sink); break;
+            case kE3CTwo: E3CEnumerateSorted<kE3CTwo>(a, b, c, norm, normTru, ws, sink); break;
+            case kE3CAllDiff: E3CEnumerateSorted<kE3CAllDiff>(a, b, c, norm, normTru, ws, sink); break;
+            default: break;
+        }
+    }
+    else {
+        switch (mode) {
+            case kE3CSameJet: E3CEnumerate<kE3CSameJet>(a, b, c, norm, normTru, ws, sink); break;
+            case kE3CSameMB: E3CEnumerate<kE3CSameMB>(a, b, c, norm, normTru, ws, sink); break;
+            case kE3CTwo: E3CEnumerate<kE3CTwo>(a, b, c, norm, normTru, ws, sink); break;
+            case kE3CAllDiff: E3CEnumerate<kE3CAllDiff>(a, b, c, norm, normTru, ws, sink); break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+template <bool Matched, bool CFactor, class Out>
+void E3CComputeFor(E3CMode mode, E3CEngine engine, const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                   double jetpt, double pt, E3CWorkspace &ws, const E3CHistBank &bank, Out &out)
+{
+    const double norm = 1. / (jetpt * jetpt * jetpt);
+    const double normTru = 1. / (pt * pt * pt);
+    if (E3CAccumulate<Matched, CFactor>(mode, engine, a, b, c, norm, normTru, ws, bank))
+        ws.acc.Flush<Matched, CFactor>(bank, out, jetpt, pt);
+}
+
+//Flush with the (matched, cfactor) of the call chosen at run time
+template <class Out>
+void E3CFlush(bool matched, bool cfactor, E3CJetAccumulator &acc, const E3CHistBank &bank, Out &out, double jetpt, double pt)
+{
+    if (matched) {
+        if (cfactor) acc.Flush<true, true>(bank, out, jetpt, pt);
+        else acc.Flush<true, false>(bank, out, jetpt, pt);
+    }
+    else {
+        if (cfactor) acc.Flush<false, true>(bank, out, jetpt, pt);
+        else acc.Flush<false, false>(bank, out, jetpt, pt);
+    }
+}
+
+//Picks the (mode, matched, cfactor) instantiation once per jet
+template <class Out>
+void E3CCompute(E3CMode mode, E3CEngine engine, bool matched, bool cfactor,
+                const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                double jetpt, double pt, E3CWorkspace &ws, const E3CHistBank &bank, Out &out)
+{
+    if (matched) {
+        if (cfactor) E3CComputeFor<true, true>(mode, engine, a, b, c, jetpt, pt, ws, bank, out);
+        else E3CComputeFor<true, false>(mode, engine, a, b, c, jetpt, pt, ws, bank, out);
+    }
+    else {
+        if (cfactor) E3CComputeFor<false, true>(mode, engine, a, b, c, jetpt, pt, ws, bank, out);
+        else E3CComputeFor<false, false>(mode, engine, a, b, c, jetpt, pt, ws, bank, out);
+    }
+}
+
+inline void E3CCompute(E3CMode mode, E3CEngine engine, bool matched, bool cfactor,
+                       const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                       double jetpt, double pt, E3CWorkspace &ws, E3CHistBank &bank)
+{
+    E3CCompute(mode, engine, matched, cfactor, a, b, c, jetpt, pt, ws, bank, bank);
+}
+
+//________________________________________________________________________
+//One triplet-engine call split over the particles i of the bucketed list
+//a (E3CParallel): E3CSplitPrepare buckets the lists and builds the pair
+//caches once, E3CSplitTile enumerates one i range into its own
+//accumulator, and E3CSplitFinish merges the tile accumulators in tile
+//order and flushes. The tiles depend only on the multiplicity, so the
+//output does not depend on which thread ran which tile.
+static const int kE3CMaxTiles = 32;
+
+//Cuts [0, nA) into nTiles ranges of about equal work, tile t being
+//[begin[t], begin[t+1]). In the one-list modes particle i closes
+//(nA-1-i)(nA-2-i)/2 triplets and nA-1-i coincident pairs, so the tiles
+//widen along the list; with two or three lists every i costs the same.
+inline int E3CSplitTiles(E3CMode mode, int nA, std::vector<int> &begin)
+{
+    const int nTiles = std::max(1, std::min(kE3CMaxTiles, nA / 16));
+    const bool single = E3CSingleList(mode);
+    auto cost = [&](int i) { return single ? 0.5 * (nA - 1 - i) * (nA - i) : 1.; };
+    double total = 0;
+    for (int i = 0; i < nA; i++) total += cost(i);
+    begin.assign(nTiles + 1, nA);
+    begin[0] = 0;
+    double sum = 0;
+    int t = 1;
+    for (int i = 0; i < nA && t < nTiles; i++) {
+        sum += cost(i);
+        while (t < nTiles && sum >= total * t / nTiles) begin[t++] = i + 1;
+    }
+    return nTiles;
+}
+
+inline void E3CSplitPrepare(E3CMode mode, const E3CParticleBlock &a, const E3CParticleBlock &b,
+                            const E3CParticleBlock &c, E3CWorkspace &ws)
+{
+    switch (mode) {
+        case kE3CSameJet: E3CPrepare<kE3CSameJet>(a, b, c, ws); break;
+        case kE3CSameMB: E3CPrepare<kE3CSameMB>(a, b, c, ws); break;
+        case kE3CTwo: E3CPrepare<kE3CTwo>(a, b, c, ws); break;
+        case kE3CAllDiff: E3CPrepare<kE3CAllDiff>(a, b, c, ws); break;
+        default: break;
+    }
+}
+
+//ws is only read, acc and trip belong to the tile
+template <bool Matched, bool CFactor>
+void E3CSplitTileFor(E3CMode mode, const E3CWorkspace &ws, int iBegin, int iEnd, double jetpt, double pt,
+                     const E3CHistBank &bank, E3CJetAccumulator &acc, E3CTripletScratch &trip)
+{
+    const E3CHistSink<Matched, CFactor> sink(bank, acc);
+    if (!sink.enabled) return;
+    const double norm = 1. / (jetpt * jetpt * jetpt);
+    const double normTru = 1. / (pt * pt * pt);
+    switch (mode) {
+        case kE3CSameJet: E3CEnumerateRange<kE3CSameJet>(ws, iBegin, iEnd, norm, normTru, trip, sink); break;
+        case kE3CSameMB: E3CEnumerateRange<kE3CSameMB>(ws, iBegin, iEnd, norm, normTru, trip, sink); break;
+        case kE3CTwo: E3CEnumerateRange<kE3CTwo>(ws, iBegin, iEnd, norm, normTru, trip, sink); break;
+        case kE3CAllDiff: E3CEnumerateRange<kE3CAllDiff>(ws, iBegin, iEnd, norm, normTru, trip, sink); break;
+        default: break;
+    }
+}
+
+inline void E3CSplitTile(E3CMode mode, bool matched, bool cfactor, const E3CWorkspace &ws, int iBegin, int iEnd,
+                         double jetpt, double pt, const E3CHistBank &bank, E3CJetAccumulator &acc, E3CTripletScratch &trip)
+{
+    if (matched) {
+        if (cfactor) E3CSplitTileFor<true, true>(mode, ws, iBegin, iEnd, jetpt, pt, bank, acc, trip);
+        else E3CSplitTileFor<true, false>(mode, ws, iBegin, iEnd, jetpt, pt, bank, acc, trip);
+    }
+    else {
+        if (cfactor) E3CSplitTileFor<false, true>(mode, ws, iBegin, iEnd, jetpt, pt, bank, acc, trip);
+        else E3CSplitTileFor<false, false>(mode, ws, iBegin, iEnd, jetpt, pt, bank, acc, trip);
+    }
+}
+
+template <class Out>
+void E3CSplitFinish(bool matched, bool cfactor, E3CJetAccumulator &acc, std::vector<E3CJetAccumulator> &tiles, int nTiles,
+                    double jetpt, double pt, const E3CHistBank &bank, Out &out)
+{
+    if (acc.configured != &bank) acc.Configure(bank);
+    for (int t = 0; t < nTiles; t++)
+        if (tiles[t].configured) acc.Merge(tiles[t]);
+    E3CFlush(matched, cfactor, acc, bank, out, jetpt, pt);
+}
+
+//________________________________________________________________________
+//Nested cones (SetE3CConeRadii): a call reading lists with nRadii > 0
+//(E3CFillNested) is enumerated once, with the triplet engine, for all
+//radii. Radius r is a suffix of every nested list, and its new terms,
+//those inside r with a particle outside r-1, are the disjoint boxes
+//{i new} + {i old, j new} + {i old, j old, k new} of the list ranges; in
+//the one-list modes, where j, k > i, only the first. The accumulator
+//grows radius by radius and is flushed, kept, into banks[r] after each,
+//so a radius reuses all the sums of the radii inside it. Lists without
+//radii count as old for every radius.
+template <bool Matched, bool CFactor>
+void E3CComputeNestedFor(E3CMode mode, const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c,
+                         int nR, double jetpt, double pt, E3CWorkspace &ws, const E3CHistBank &main, E3CHistBank *const *banks)
+{
+    const E3CHistSink<Matched, CFactor> sink(main, ws.acc);
+    if (!sink.enabled) return;
+    const double norm = 1. / (jetpt * jetpt * jetpt);
+    const double normTru = 1. / (pt * pt * pt);
+    E3CSplitPrepare(mode, a, b, c, ws);
+    const int nLists = E3CSingleList(mode) ? 1 : (mode == kE3CAllDiff ? 3 : 2);
+    const E3CParticleBlock *lists[3] = {&a, &b, &c};
+    for (int r = 0; r < nR; r++) {
+        int lo[3], mid[3], n[3]; //new = [lo, mid), old = [mid, n)
+        for (int l = 0; l < nLists; l++) {
+            const E3CParticleBlock &x = *lists[l];
+            n[l] = x.Size();
+            lo[l] = x.nRadii ? x.radiusBegin[r] : 0;
+            mid[l] = x.nRadii ? (r ? x.radiusBegin[r - 1] : n[l]) : 0;
+        }
+        for (int box = 0; box < nLists; box++) {
+            int range[3][2] = {{0, INT_MAX}, {0, INT_MAX}, {0, INT_MAX}};
+            for (int l = 0; l < nLists; l++) {
+                range[l][0] = l < box ? mid[l] : lo[l];
+                range[l][1] = l == box ? mid[l] : n[l];
+            }
+            if (range[box][0] >= range[box][1]) continue;
+            switch (mode) {
+                case kE3CSameJet: E3CEnumerateRange<kE3CSameJet>(ws, range[0][0], range[0][1], norm, normTru, ws.trip, sink); break;
+                case kE3CSameMB: E3CEnumerateRange<kE3CSameMB>(ws, range[0][0], range[0][1], norm, normTru, ws.trip, sink); break;
+                case kE3CTwo: E3CEnumerateRange<kE3CTwo>(ws, range[0][0], range[0][1], norm, normTru, ws.trip, sink, range[1][0], range[1][1]); break;
+                case kE3CAllDiff:
+                    E3CEnumerateRange<kE3CAllDiff>(ws, range[0][0], range[0][1], norm, normTru, ws.trip, sink,
+                                                   range[1][0], range[1][1], range[2][0], range[2][1]);
+                    break;
+                default: break;
+            }
+        }
+        ws.acc.Flush<Matched, CFactor>(*banks[r], *banks[r], jetpt, pt, r + 1 < nR);
+    }
+}
+
+inline void E3CComputeNested(E3CMode mode, bool matched, bool cfactor, const E3CParticleBlock &a, const E3CParticleBlock &b,
+                             const E3CParticleBlock &c, int nR, double jetpt, double pt, E3CWorkspace &ws,
+                             const E3CHistBank &main, E3CHistBank *const *banks)
+{
+    if (matched) {
+        if (cfactor) E3CComputeNestedFor<true, true>(mode, a, b, c, nR, jetpt, pt, ws, main, banks);
+        else E3CComputeNestedFor<true, false>(mode, a, b, c, nR, jetpt, pt, ws, main, banks);
+    }
+    else {
+        if (cfactor) E3CComputeNestedFor<false, true>(mode, a, b, c, nR, jetpt, pt, ws, main, banks);
+        else E3CComputeNestedFor<false, false>(mode, a, b, c, nR, jetpt, pt, ws, main, banks);
+    }
+}
+
+//true if a list the mode reads is a nested cone
+inline bool E3CNested(E3CMode mode, const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c)
+{
+    return a.nRadii || (!E3CSingleList(mode) && b.nRadii) || (mode == kE3CAllDiff && c.nRadii);
+}
+
+//________________________________________________________________________
+//Projected N-point energy correlators (AddE3CENCFamily): the E2C (EEC),
+//E3C and E4C of one particle list in one walk, E3CEnumerateENC. Every set
+//of k >= 2 distinct particles i1 < ... < ik is visited once, reading the
+//pair cache of the list for all orders, and closes for each order
+//n = k..N every way of giving its particles multiplicities m1..mk >= 1
+//summing to n: the distinct term with n! orderings and the coincident
+//ones (iij, ijj, iijj, ...) with n!/(m1!...mk!). A term weighs
+//pT_i1^m1...pT_ik^mk/jetpt^n (pt^n for truth) at R_L, the largest pair
+//distance of the set, which is kept running as the set grows; with rlMax
+//a set at or beyond it is not extended, as every extension has a larger
+//R_L. Self terms (one particle n times, R_L = 0) are left out, as in
+//ComputeE3C.
+
+//Families of each order, up to kE3CNCategories, filled as response
+//families (jetpt, pt, R_L) into category slot f of the bank of that
+//order. A label gives the origin codes of the n particles of a term,
+//counted with multiplicity, in the tokens of the E3C names: J (0 or 1),
+//B (0), S (1), MB or MB1 (-2), MB2 (-3), MB3 (-4); "MJ" takes every term.
+//On a jet with its thermal cones appended, "JJMB" is the order-3
+//jet-jet-cone term and "MB1MB1MB1MB1" the order-4 cone one, whatever the
+//order in which the codes come in the list.
+struct E3CENCFamilies
+{
+    struct Composition
+    {
+        int n;                //order
+        int m[kE3CMaxOrder];  //multiplicities of the k particles
+        double orderings;     //n!/(m1!...mk!)
+    };
+
+    int order = 0;             //N, 0 = off
+    double rlMax = HUGE_VAL;   //pruning, none by default
+    std::vector<std::string> labels[kE3CMaxOrder + 1];
+    //set by Build
+    int codeWeight[kE3CNCodes];                              //key of a code count: sum count * codeWeight
+    std::vector<unsigned int> mask[kE3CMaxOrder + 1];        //[key] families of order n
+    std::vector<Composition> compositions[kE3CMaxOrder + 1]; //[k], all orders
+
+    //false for an order outside 2..kE3CMaxOrder, a full order or a label
+    //that is not n tokens
+    bool Add(int n, const std::string &label)
+    {
+        int count[6];
+        if (n < 2 || n > kE3CMaxOrder || (int)labels[n].size() >= kE3CNCategories || !Parse(label, n, count)) return false;
+        labels[n].push_back(label);
+        order = std::max(order, n);
+        return true;
+    }
+
+    //token counts J, B, S, MB1, MB2, MB3 of a label, count[0] = -1 for "MJ"
+    static bool Parse(const std::string &label, int n, int *count)
+    {
+        std::fill(count, count + 6, 0);
+        if (label == "MJ") { count[0] = -1; return true; }
+        static const char *kToken[7] = {"MB1", "MB2", "MB3", "MB", "J", "B", "S"};
+        static const int kSlot[7] = {3, 4, 5, 3, 0, 1, 2};
+        int total = 0;
+        for (size_t pos = 0; pos < label.size(); total++) {
+            int t = 0;
+            while (t < 7 && label.compare(pos, std::strlen(kToken[t]), kToken[t]) != 0) t++;
+            if (t == 7) return false;
+            count[kSlot[t]]++;
+            pos += std::strlen(kToken[t]);
+        }
+        return total == n;
+    }
+
+    //does a term with codeCount[q] particles of code index q belong to the label
+    static bool Matches(const int *count, const int *codeCount)
+    {
+        if (count[0] < 0) return true;
+        const int nB = codeCount[E3CCodeIndex(0)], nS = codeCount[E3CCodeIndex(1)];
+        return codeCount[E3CCodeIndex(-2)] == count[3] && codeCount[E3CCodeIndex(-3)] == count[4] &&
+               codeCount[E3CCodeIndex(-4)] == count[5] && codeCount[E3CCodeIndex(-1)] == 0 && codeCount[kE3CNCodes - 1] == 0 &&
+               nB >= count[1] && nS >= count[2] && nB + nS == count[0] + count[1] + count[2];
+    }
+
+    //family masks per code count and the compositions; once, after the Add calls
+    void Build()
+    {
+        for (int q = 0, w = 1; q < kE3CNCodes; q++, w *= order + 1) codeWeight[q] = w;
+        const int nKeys = codeWeight[kE3CNCodes - 1] * (order + 1);
+        for (int n = 0; n <= kE3CMaxOrder; n++) {
+            mask[n].clear();
+            compositions[n].clear();
+        }
+        for (int n = 2; n <= order; n++) {
+            mask[n].assign(nKeys, 0);
+            for (int f = 0; f < (int)labels[n].size(); f++) {
+                int count[6];
+                Parse(labels[n][f], n, count);
+                for (int key = 0; key < nKeys; key++) {
+                    int codeCount[kE3CNCodes], total = 0;
+                    for (int q = 0; q < kE3CNCodes; q++) total += codeCount[q] = key / codeWeight[q] % (order + 1);
+                    if (total == n && Matches(count, codeCount)) mask[n][key] |= E3CBit(f);
+                }
+            }
+        }
+        double factorial[kE3CMaxOrder + 1] = {1};
+        for (int n = 1; n <= kE3CMaxOrder; n++) factorial[n] = n * factorial[n - 1];
+        for (int k = 2; k <= order; k++) {
+            //every m in [1, order-k+1]^k, kept if it sums to an order
+            Composition c;
+            std::fill(c.m, c.m + kE3CMaxOrder, 1);
+            while (true) {
+                c.n = 0;
+                c.orderings = 1;
+                for (int t = 0; t < k; t++) { c.n += c.m[t]; c.orderings /= factorial[c.m[t]]; }
+                c.orderings *= factorial[std::min(c.n, kE3CMaxOrder)];
+                if (c.n <= order && !labels[c.n].empty()) compositions[k].push_back(c);
+                int t = 0;
+                while (t < k && c.m[t] == order - k + 1) c.m[t++] = 1;
+                if (t == k) break;
+                c.m[t]++;
+            }
+        }
+    }
+};
+
+//Depth-first walk over the particle sets of E3CEnumerateENC; K particles
+//are chosen in Extend<K>, the sets end at N
+template <int N>
+struct E3CENCWalk
+{
+    const E3CENCFamilies &fam;
+    const E3CParticleBlock &list;
+    const E3CPairCache &pairs;
+    E3CJetAccumulator *acc[N + 1];
+    unsigned int enabled[N + 1];
+    double norm[N + 1], normTru[N + 1];
+    int idx[N];
+    int key[N];             //codeWeight of each chosen particle
+    double ptPow[N][N + 1]; //its pT^m
+    long evaluated = 0;     //particle sets closed, E3C_INSTRUMENT only
+
+    E3CENCWalk(const E3CENCFamilies &famIn, const E3CParticleBlock &listIn, const E3CPairCache &pairsIn)
+        : fam(famIn), list(listIn), pairs(pairsIn) {}
+
+    template <int K>
+    void Extend(int from, double RL)
+    {
+        for (int i = from; i < list.Size(); i++) {
+            double R = RL;
+            for (int t = 0; t < K && R < fam.rlMax; t++) R = std::max(R, pairs.DeltaR(idx[t], i));
+            if (R >= fam.rlMax) continue;
+            idx[K] = i;
+            key[K] = fam.codeWeight[E3CCodeIndex(list.cat[i])];
+            ptPow[K][0] = 1;
+            for (int m = 1; m <= N; m++) ptPow[K][m] = ptPow[K][m - 1] * list.pt[i];
+            if (K >= 1) Close(K + 1, R);
+            Next<K + 1>(i + 1, R, std::integral_constant<bool, (K + 1 < N)>());
+        }
+    }
+
+    template <int K>
+    void Next(int from, double RL, std::true_type) { Extend<K>(from, RL); }
+    template <int K>
+    void Next(int, double, std::false_type) {}
+
+    //the terms of the k chosen particles, one response entry each
+    void Close(int k, double RL)
+    {
+        E3C_INSTR(evaluated++;)
+        for (const E3CENCFamilies::Composition &c : fam.compositions[k]) {
+            int code = 0;
+            double w = c.orderings;
+            for (int t = 0; t < k; t++) {
+                code += c.m[t] * key[t];
+                w *= ptPow[t][c.m[t]];
+            }
+            const unsigned int mask = fam.mask[c.n][code] & enabled[c.n];
+            if (!mask) continue;
+            const double wr = w * norm[c.n], wt = w * normTru[c.n];
+            E3C_INSTR(acc[c.n]->filled++;)
+            acc[c.n]->AddResponse(mask, RL, wr, wr * wr, wt, wt * wt, 1);
+        }
+    }
+};
+
+//Correlators of order 2..N of one list into banks[n], family f in category
+//slot f. The list is bucketed and its pair cache built as for a one-list
+//ComputeE3C call
+template <int N, bool Matched, bool CFactor>
+void E3CComputeENCFor(const E3CENCFamilies &fam, const E3CParticleBlock &list, double jetpt, double pt, E3CWorkspace &ws, E3CHistBank *const *banks)
+{
+    E3CENCWalk<N> walk(fam, ws.partA.block, ws.same);
+    unsigned int any = 0;
+    for (int n = 2; n <= N; n++) {
+        const E3CHistSink<Matched, CFactor> sink(*banks[n], ws.enc[n]);
+        walk.acc[n] = &ws.enc[n];
+        any |= walk.enabled[n] = sink.enabled4;
+        walk.norm[n] = std::pow(jetpt, -n);
+        walk.normTru[n] = std::pow(pt, -n);
+    }
+    if (!any) return;
+    E3CPrepare<kE3CSameJet>(list, list, list, ws);
+    walk.template Extend<0>(0, 0.);
+    E3C_INSTR(ws.trip.evaluated += walk.evaluated;)
+    for (int n = 2; n <= N; n++) ws.enc[n].Flush<Matched, CFactor>(*banks[n], *banks[n], jetpt, pt);
+}
+
+template <int N>
+void E3CComputeENCOrder(const E3CENCFamilies &fam, bool matched, bool cfactor, const E3CParticleBlock &list,
+                        double jetpt, double pt, E3CWorkspace &ws, E3CHistBank *const *banks)
+{
+    if (matched) {
+        if (cfactor) E3CComputeENCFor<N, true, true>(fam, list, jetpt, pt, ws, banks);
+        else E3CComputeENCFor<N, true, false>(fam, list, jetpt, pt, ws, banks);
+    }
+    else {
+        if (cfactor) E3CComputeENCFor<N, false, true>(fam, list, jetpt, pt, ws, banks);
+        else E3CComputeENCFor<N, false, false>(fam, list, jetpt, pt, ws, banks);
+    }
+}
+
+//banks[n] for n = 0..kE3CMaxOrder, set up for the families of fam
+inline void E3CComputeENC(const E3CENCFamilies &fam, bool matched, bool cfactor, const E3CParticleBlock &list,
+                          double jetpt, double pt, E3CWorkspace &ws, E3CHistBank *const *banks)
+{
+    switch (fam.order) {
+        case 2: E3CComputeENCOrder<2>(fam, matched, cfactor, list, jetpt, pt, ws, banks); break;
+        case 3: E3CComputeENCOrder<3>(fam, matched, cfactor, list, jetpt, pt, ws, banks); break;
+        case 4: E3CComputeENCOrder<4>(fam, matched, cfactor, list, jetpt, pt, ws, banks); break;
+        default: break;
+    }
+}
+
+//________________________________________________________________________
+//Event-scoped cache of the thermal cones (SetE3CConeCache). The cone axes
+//only depend on the jet direction, so jets whose cones coincide within
+//tolerance in eta and phi share one selected track list, and the MB-only
+//calls on the same cones (MB1MB1MB1, MB1MB2MB2, MB1MB2MB3) share their
+//response and moments sums. Those are computed once with unit
+//normalisation and rescaled to 1/jetpt^3 (1/pt^3 for truth) per jet,
+//which only moves the last bits of the sums. Weight-axis families bin the
+//normalised weight, so calls reaching one are always recomputed.
+struct E3CConeCache
+{
+    struct Cone
+    {
+        int code;
+        double eta, phi, ptMin;  //quantised axis, track cut
+        E3CParticleBlock *block; //from the event's E3CBlockPool
+    };
+    struct Terms
+    {
+        E3CMode mode;
+        bool matched, cfactor;
+        int cones[3];
+        E3CJetAccumulator::RLSums::Snapshot resp, mom;
+    };
+
+    bool enabled = false;
+    double tolerance = 0; //0: axes must be equal
+    std::vector<Cone> cones; //reused from event to event, the first nCones are valid
+    int nCones = 0;
+    std::vector<Terms> terms;
+    int nTerms = 0;
+    double coneLookups = 0, coneHits = 0, termLookups = 0, termHits = 0;
+
+    //with the pool of the blocks, at the start of an event
+    void Clear() { nCones = nTerms = 0; }
+
+    double Quantise(double x) const { return tolerance > 0 ? std::round(x / tolerance) : x; }
+
+    //Block of cone code around (eta, phi) with tracks from ptMin, taken
+    //from pool if new; fresh is then set and the block still has to be filled
+    E3CParticleBlock *Find(int code, double eta, double phi, double ptMin, E3CBlockPool &pool, bool &fresh)
+    {
+        eta = Quantise(eta);
+        phi = Quantise(E3CTrackGrid::Wrap(phi));
+        coneLookups++;
+        for (int i = 0; i < nCones; i++) {
+            const Cone &c = cones[i];
+            if (c.code == code && c.eta == eta && c.phi == phi && c.ptMin == ptMin) {
+                coneHits++;
+                fresh = false;
+                return c.block;
+            }
+        }
+        if (nCones == (int)cones.size()) cones.emplace_back();
+        Cone &c = cones[nCones];
+        c.code = code; c.eta = eta; c.phi = phi; c.ptMin = ptMin;
+        c.block = &pool.Get();
+        c.block->cone = nCones++;
+        fresh = true;
+        return c.block;
+    }
+
+    //every list the mode reads comes from the cache
+    static bool ConesOnly(E3CMode mode, const E3CParticleBlock &a, const E3CParticleBlock &b, const E3CParticleBlock &c)
+    {
+        return a.cone >= 0 && (E3CSingleList(mode) || b.cone >= 0) && (mode != kE3CAllDiff || c.cone >= 0);
+    }
+
+    //ComputeE3C of a ConesOnly call without weight-axis families
+    void Compute(E3CMode mode, E3CEngine engine, bool matched, bool cfactor, const E3CParticleBlock &a,
+                 const E3CParticleBlock &b, const E3CParticleBlock &c, double jetpt, double pt,
+                 E3CWorkspace &ws, E3CHistBank &bank)
+    {
+        const int ids[3] = {a.cone, E3CSingleList(mode) ? -1 : b.cone, mode == kE3CAllDiff ? c.cone : -1};
+        termLookups++;
+        int t = 0;
+        for (; t < nTerms; t++) {
+            const Terms &e = terms[t];
+            if (e.mode == mode && e.matched == matched && e.cfactor == cfactor &&
+                e.cones[0] == ids[0] && e.cones[1] == ids[1] && e.cones[2] == ids[2]) break;
+        }
+        if (t < nTerms) termHits++;
+        else {
+            if (nTerms == (int)terms.size()) terms.emplace_back();
+            Terms &e = terms[nTerms++];
+            e.mode = mode; e.matched = matched; e.cfactor = cfactor;
+            std::copy(ids, ids + 3, e.cones);
+            //unit normalisation; nothing is added if no family is booked for (matched, cfactor)
+            if (matched) {
+                if (cfactor) E3CAccumulate<true, true>(mode, engine, a, b, c, 1., 1., ws, bank);
+                else E3CAccumulate<true, false>(mode, engine, a, b, c, 1., 1., ws, bank);
+            }
+            else {
+                if (cfactor) E3CAccumulate<false, true>(mode, engine, a, b, c, 1., 1., ws, bank);
+                else E3CAccumulate<false, false>(mode, engine, a, b, c, 1., 1., ws, bank);
+            }
+            ws.acc.resp.Save(e.resp);
+            ws.acc.mom.Save(e.mom);
+            ws.acc.resp.Reset();
+            ws.acc.mom.Reset();
+        }
+        const Terms &e = terms[t];
+        if (!e.resp.used && !e.mom.used) return;
+        const double norm = 1. / (jetpt * jetpt * jetpt);
+        const double normTru = 1. / (pt * pt * pt);
+        ws.acc.resp.AddScaled(e.resp, norm, normTru);
+        ws.acc.mom.AddScaled(e.mom, norm, normTru);
+        E3CFlush(matched, cfactor, ws.acc, bank, bank, jetpt, pt);
+    }
+};
+
+//________________________________________________________________________
+//Per-call engine choice. The sorted-pair engine only saves work on the
+//response and moments families, so it is used when no weight-axis
+//histogram can be reached for the call and the multiplicity of the lists
+//the mode reads (a; a+b; a+b+c) is at or above the threshold of the mode.
+//Thresholds not set from the AddTask take the fixed defaults below, so
+//every job and rerun picks the same engine for the same call; the engines
+//add the terms in different orders, and a timed choice would make the last
+//bits of the output depend on the node. Calibrate() is the opt-in
+//alternative (SetE3CEngineCalibration).
+static const int kE3CEngineThresholdDefault[kE3CNModes] = {16, 16, 24, 32}; //Calibrate() on an AVX2 node
+
+struct E3CDispatcher
+{
+    E3CEngine forced = kE3CEngineAuto;
+    int threshold[kE3CNModes] = {-1, -1, -1, -1}; //<0: not set, Calibrate() or Defaults()
+    bool has3D[kE3CNModes][2][2] = {};             //[mode][matched][cfactor]
+
+    static int Multiplicity(E3CMode mode, int na, int nb, int nc)
+    {
+        return E3CSingleList(mode) ? na : (mode == kE3CAllDiff ? na + nb + nc : na + nb);
+    }
+
+    //weight-axis families reachable per (mode, matched, cfactor)
+    void Configure(const E3CHistBank &bank)
+    {
+        for (int m = 0; m < kE3CNModes; m++) {
+            unsigned int cats = 0;
+            for (int t = 0; t < E3CCategoryLUT::kSize; t++) cats |= E3CCategoryLUT::mask[m][t];
+            for (int matched = 0; matched < 2; matched++) {
+                for (int cf = 0; cf < 2; cf++) {
+                    const int reco = matched ? (cf ? kE3CCM : kE3CM) : (cf ? kE3CCUM : kE3CUM);
+                    const int tru = cf ? kE3CTruCM : kE3CTruM;
+                    bool any = false;
+                    for (int c = 0; c < kE3CNCategories; c++) {
+                        if (!(cats & E3CBit(c))) continue;
+                        any = any || bank.Booked(kE3CWeightAxis, c, kE3CIncl) || bank.Booked(kE3CWeightAxis, c, reco) || (matched && bank.Booked(kE3CWeightAxis, c, tru));
+                    }
+                    has3D[m][matched][cf] = any;
+                }
+            }
+        }
+    }
+
+    E3CEngine Choose(E3CMode mode, bool matched, bool cfactor, int na, int nb, int nc) const
+    {
+        if (forced != kE3CEngineAuto) return forced;
+        if (has3D[mode][matched][cfactor] || threshold[mode] < 0) return kE3CEngineTriplet;
+        return Multiplicity(mode, na, nb, nc) >= threshold[mode] ? kE3CEngineSortedPairs : kE3CEngineTriplet;
+    }
+
+    //kE3CEngineThresholdDefault for the modes still without a threshold
+    void Defaults()
+    {
+        for (int m = 0; m < kE3CNModes; m++)
+            if (threshold[m] < 0) threshold[m] = kE3CEngineThresholdDefault[m];
+    }
+
+    //Times both engines on random blocks shaped like the task's calls
+    //(jet codes for the same-jet mode, cone codes otherwise) and sets the
+    //threshold of each uncalibrated mode to the smallest multiplicity from
+    //which the sorted-pair engine is faster at three consecutive sizes,
+    //INT_MAX if it never is.
+    void Calibrate(E3CWorkspace &ws, unsigned int seed = 12345)
+    {
+        static const int kSizes[] = {8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+        const int nSizes = sizeof(kSizes) / sizeof(kSizes[0]);
+
+        //response and moments families, one bin per axis
+        static const double kOneBin[2] = {0., 1e30};
+        E3CHistBank bench;
+        for (int c = 0; c < kE3CNCategories; c++) {
+            bench.SetAxes(kE3CResponse, c, 1, kOneBin, 1, kOneBin, 1, kOneBin);
+            bench.SetAxes(kE3CMoments, c, 1, kOneBin, 1, kOneBin);
+            for (int v = 0; v < kE3CNVariants; v++) {
+                bench.Book(kE3CResponse, c, v);
+                bench.Book(kE3CMoments, c, v);
+            }
+        }
+        bench.Allocate();
+
+        unsigned int state = seed;
+        auto uniform = [&state]() { state = state * 1664525u + 1013904223u; return (state >> 8) * (1. / 16777216.); };
+        auto make = [&](E3CParticleBlock &blk, int n, const int *codes, int nCodes) {
+            blk.Clear();
+            for (int i = 0; i < n; i++)
+                blk.Add(1. + 9. * uniform(), 0.8 * (uniform() - 0.5), 0.8 * (uniform() - 0.5),
+                        codes[std::min(nCodes - 1, (int)(uniform() * nCodes))]);
+        };
+        static const int kJetCodes[] = {0, 1, -1};
+        static const int kCone1[] = {-2};
+        static const int kCone2[] = {-3};
+
+        E3CParticleBlock a, b, c;
+        for (int m = 0; m < kE3CNModes; m++) {
+            if (threshold[m] >= 0) continue;
+            const E3CMode mode = (E3CMode)m;
+            threshold[m] = INT_MAX;
+            int firstFaster = -1;
+            int nFaster = 0;
+            for (int s = 0; s < nSizes; s++) {
+                const int n = kSizes[s];
+                if (mode == kE3CSameJet) make(a, n, kJetCodes, 3);
+                else if (mode == kE3CSameMB) make(a, n, kCone1, 1);
+                else if (mode == kE3CTwo) { make(a, n / 2, kCone1, 1); make(b, n - n / 2, kJetCodes, 2); }
+                else { make(a, n / 3, kJetCodes, 2); make(b, n / 3, kCone1, 1); make(c, n - 2 * (n / 3), kCone2, 1); }
+                double t[kE3CNEngines];
+                for (int e = 0; e < kE3CNEngines; e++) t[e] = Time(mode, (E3CEngine)e, a, b, c, ws, bench);
+                if (t[kE3CEngineSortedPairs] < t[kE3CEngineTriplet]) {
+                    if (firstFaster < 0) firstFaster = n;
+                    if (++nFaster == 3) break; //the gap only widens with n
+                }
+                else { firstFaster = -1; nFaster = 0; }
+            }
+            if (nFaster == 3) threshold[m] = firstFaster;
+        }
+    }
+
+    //best of three runs, seconds
+    static double Time(E3CMode mode, E3CEngine engine, const E3CParticleBlock &a, const E3CParticleBlock &b,
+                       const E3CParticleBlock &c, E3CWorkspace &ws, E3CHistBank &bank)
+    {
+        double best = 1e30;
+        for (int r = 0; r < 3; r++) {
+            const auto t0 = std::chrono::steady_clock::now();
+            E3CCompute(mode, engine, true, false, a, b, c, 50., 50., ws, bank);
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+        }
+        return best;
+    }
+};
+
+//________________________________________________________________________
+//Output of one ComputeE3C call kept aside instead of added to the bank:
+//the touched histograms with their statistics and entries, and the cells
+//in the order Flush produced them. Apply replays them into the bank, so
+//the bank sees exactly the additions, in the same order, of a direct flush.
+struct E3CFlushRecord
+{
+    struct Target
+    {
+        int kind, category, variant;
+    };
+    struct Cell
+    {
+        int target;
+        long bin;
+        double w, w2, n;
+    };
+    std::vector<Target> targets;
+    std::vector<Cell> cells;
+    std::vector<double> stats;   //kNStats per target
+    std::vector<double> entries; //per target
+    int index[kE3CNKinds][kE3CNCategories][kE3CNVariants]; //target of a histogram, -1 if not touched
+
+    E3CFlushRecord()
+    {
+        for (int k = 0; k < kE3CNKinds; k++)
+            for (int c = 0; c < kE3CNCategories; c++)
+                for (int v = 0; v < kE3CNVariants; v++) index[k][c][v] = -1;
+    }
+
+    void Clear()
+    {
+        for (const Target &t : targets) index[t.kind][t.category][t.variant] = -1;
+        targets.clear(); cells.clear(); stats.clear(); entries.clear();
+    }
+
+    //the interface E3CJetAccumulator::Flush writes through, as on the bank
+    int GetTarget(int kind, int category, int variant)
+    {
+        int &i = index[kind][category][variant];
+        if (i < 0) {
+            i = (int)targets.size();
+            targets.push_back({kind, category, variant});
+            stats.resize(stats.size() + E3CHistBank::kNStats, 0.);
+            entries.push_back(0.);
+        }
+        return i;
+    }
+    void Add(int, int target, long bin, double w, double w2, double n) { cells.push_back({target, bin, w, w2, n}); }
+    double *Stats(int kind, int category, int variant) { return &stats[(size_t)GetTarget(kind, category, variant) * E3CHistBank::kNStats]; }
+    double &Entries(int kind, int category, int variant) { return entries[GetTarget(kind, category, variant)]; }
+
+    void Apply(E3CHistBank &bank) const
+    {
+        std::vector<E3CHistBank::Target> dest(targets.size());
+        for (size_t i = 0; i < targets.size(); i++) {
+            const Target &t = targets[i];
+            dest[i] = bank.GetTarget(t.kind, t.category, t.variant);
+            E3CJetAccumulator::AddToStats(bank.Stats(t.kind, t.category, t.variant), &stats[i * E3CHistBank::kNStats]);
+            bank.Entries(t.kind, t.category, t.variant) += entries[i];
+        }
+        for (const Cell &cell : cells) bank.Add(targets[cell.target].kind, dest[cell.target], cell.bin, cell.w, cell.w2, cell.n);
+    }
+};
+
+struct E3CParallel;
+
+#if !defined(__CLING__) && !defined(__ROOTCLING__)
+//Opt-in parallel ComputeE3C (SetE3CThreads). The calls of an event are
+//queued with Submit, which copies their particle blocks, and Run executes
+//the queue on nThreads threads (the caller included), each with its own
+//workspace and each call into its own E3CFlushRecord; the records are then
+//replayed into the bank in submission order. The bank therefore receives
+//the additions of the serial loop in the serial order, and the output is
+//bitwise identical to it whatever the number of threads.
+//
+//Triplet-engine calls at or above splitThreshold (SetE3CSplitThreshold,
+//multiplicity as in E3CDispatcher) are in addition cut into tiles of
+//their i loop (E3CSplitTiles), so one large MB1MB2MB3 call no longer keeps
+//a single thread busy while the others idle. Tile results are merged in
+//tile order: the output stays the same for any number of threads, but
+//differs from the unsplit call in the last bits of the sums.
+//
+//Tasks go through a fork-join scheduler with work stealing: each thread
+//starts with a contiguous share of the tasks, takes them from the front
+//and, once out of work, steals from the back of another thread's share.
+struct E3CParallel
+{
+    struct Job
+    {
+        E3CMode mode;
+        E3CEngine engine;
+        bool matched, cfactor;
+        E3CParticleBlock a, b, c;
+        double jetpt, pt;
+        double seconds; //compute time of the call, summed over its tiles
+        int jet = -1;   //of the caller, for E3CTrace
+        E3CFlushRecord record;
+        //split calls only
+        int nTiles = 0; //0: computed whole into record
+        std::vector<int> tileBegin;
+        std::vector<double> tileSeconds;
+        std::vector<E3CJetAccumulator> tiles;
+        E3CWorkspace split; //lists and pair caches shared by the tiles
+    };
+    struct Share
+    {
+        std::mutex mutex;
+        int begin = 0, end = 0; //tasks not taken yet
+    };
+
+    int nThreads = 1;
+    int splitThreshold = INT_MAX;
+    std::vector<Job> jobs; //reused from event to event, the first nJobs are queued
+    int nJobs = 0;
+    std::vector<E3CWorkspace> work; //[thread]
+    std::unique_ptr<Share[]> shares; //[thread]
+    std::vector<std::pair<int, int>> tileTasks; //(job, tile) of the tile phase
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::function<void(int, int)> task; //(task, thread) of the current ForEach
+    const E3CHistBank *bank = nullptr;
+    double replaySeconds = 0; //E3C_INSTRUMENT: records applied to the bank
+    int generation = 0;
+    int running = 0;
+    bool stop = false;
+
+    E3CParallel() = default;
+    E3CParallel(const E3CParallel &) = delete;
+    E3CParallel &operator=(const E3CParallel &) = delete;
+    ~E3CParallel() { Stop(); }
+
+    bool Enabled() const { return nThreads > 1; }
+
+    //Starts the nThreads - 1 helper threads; call once, after the bank is booked
+    void Start()
+    {
+        Stop();
+        const int n = std::max(nThreads, 1);
+        work.assign(n, E3CWorkspace());
+        shares.reset(new Share[n]);
+        stop = false;
+        for (int t = 1; t < nThreads; t++) threads.emplace_back(&E3CParallel::Worker, this, t);
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (std::thread &t : threads) t.join();
+        threads.clear();
+    }
+
+    void Submit(E3CMode mode, E3CEngine engine, bool matched, bool cfactor, const E3CParticleBlock &a,
+                const E3CParticleBlock &b, const E3CParticleBlock &c, double jetpt, double pt)
+    {
+        if (nJobs == (int)jobs.size()) jobs.emplace_back();
+        Job &job = jobs[nJobs++];
+        job.mode = mode;
+        job.engine = engine;
+        job.matched = matched;
+        job.cfactor = cfactor;
+        //only the lists the mode reads
+        job.a = a;
+        if (!E3CSingleList(mode)) job.b = b;
+        if (mode == kE3CAllDiff) job.c = c;
+        job.jetpt = jetpt;
+        job.pt = pt;
+        job.nTiles = 0;
+    }
+
+    bool Split(const Job &job) const
+    {
+        return job.engine == kE3CEngineTriplet &&
+               E3CDispatcher::Multiplicity(job.mode, job.a.Size(), job.b.Size(), job.c.Size()) >= splitThreshold;
+    }
+
+    //Runs the queued calls, replays them into bankIn in submission order and
+    //calls fn(job) for each, in the same order; the queue is then empty
+    template <class Fn>
+    void Run(E3CHistBank &bankIn, Fn fn)
+    {
+        if (!nJobs) return;
+        bank = &bankIn;
+
+        //whole calls, and the preparation of the split ones
+        ForEach(nJobs, [this](int i, int t) {
+            Job &job = jobs[i];
+            const auto t0 = std::chrono::steady_clock::now();
+            if (Split(job)) {
+                E3CSplitPrepare(job.mode, job.a, job.b, job.c, job.split);
+                job.nTiles = E3CSplitTiles(job.mode, job.split.partA.block.Size(), job.tileBegin);
+                if ((int)job.tiles.size() < job.nTiles) job.tiles.resize(job.nTiles);
+                job.tileSeconds.assign(job.nTiles, 0.);
+            }
+            else {
+                job.record.Clear();
+                E3CCompute(job.mode, job.engine, job.matched, job.cfactor, job.a, job.b, job.c, job.jetpt, job.pt, work[t], *bank, job.record);
+            }
+            job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        });
+
+        //tiles of the split calls
+        tileTasks.clear();
+        for (int i = 0; i < nJobs; i++)
+            for (int k = 0; k < jobs[i].nTiles; k++) tileTasks.emplace_back(i, k);
+        ForEach((int)tileTasks.size(), [this](int i, int t) {
+            Job &job = jobs[tileTasks[i].first];
+            const int k = tileTasks[i].second;
+            const auto t0 = std::chrono::steady_clock::now();
+            E3CSplitTile(job.mode, job.matched, job.cfactor, job.split, job.tileBegin[k], job.tileBegin[k + 1],
+                         job.jetpt, job.pt, *bank, job.tiles[k], work[t].trip);
+            job.tileSeconds[k] = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        });
+
+        for (int i = 0; i < nJobs; i++) {
+            Job &job = jobs[i];
+            if (job.nTiles) {
+                const auto t0 = std::chrono::steady_clock::now();
+                E3CSplitFinish(job.matched, job.cfactor, job.split.acc, job.tiles, job.nTiles, job.jetpt, job.pt, bankIn, bankIn);
+                job.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                for (int k = 0; k < job.nTiles; k++) job.seconds += job.tileSeconds[k];
+            }
+            else {
+                E3C_INSTR(const E3CScopedSum timer(replaySeconds);)
+                job.record.Apply(bankIn);
+            }
+            fn(job);
+        }
+        nJobs = 0;
+    }
+
+    //E3C_INSTRUMENT counters of all threads and tiles, the replay counted as flush time
+    void AddCounters(E3CCounters &counters) const
+    {
+        for (const E3CWorkspace &ws : work) counters.Add(ws);
+        for (const Job &job : jobs) {
+            counters.Add(job.split);
+            for (const E3CJetAccumulator &tile : job.tiles) counters.Add(tile);
+        }
+        counters.flushSeconds += replaySeconds;
+    }
+
+    //Calls fn(task, thread) for task = 0..nTasks-1 on all threads and returns
+    //when every task is done
+    template <class Fn>
+    void ForEach(int nTasks, Fn fn)
+    {
+        if (nTasks <= 0) return;
+        const int n = (int)work.size();
+        for (int t = 0; t < n; t++) {
+            shares[t].begin = (int)((long)nTasks * t / n);
+            shares[t].end = (int)((long)nTasks * (t + 1) / n);
+        }
+        task = fn;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = (int)threads.size();
+            generation++;
+        }
+        wake.notify_all();
+        Drain(0);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return running == 0; });
+        }
+    }
+
+    void Worker(int t)
+    {
+        int seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+            Drain(t);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--running == 0) done.notify_one();
+            }
+        }
+    }
+
+    //own share from the front, then steal from the back of the others
+    void Drain(int t)
+    {
+        const int n = (int)work.size();
+        for (;;) {
+            int i = -1;
+            for (int d = 0; d < n && i < 0; d++) {
+                Share &s = shares[(t + d) % n];
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (s.begin < s.end) i = d ? --s.end : s.begin++;
+            }
+            if (i < 0) return;
+            task(i, t);
+        }
+    }
+};
+
+#endif
+
+#endif
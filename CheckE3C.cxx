@@ -0,0 +1,194 @@
+// Standalone checks of the E3C helpers in AliAnalysisTaskJetsEECpbpbE3Ccode.h,
+// which need neither ROOT nor AliPhysics:
+//   g++ -O2 -std=c++11 -pthread CheckE3C.cxx -o CheckE3C && ./CheckE3C
+// unoptimised (catches in-class constants used without a definition) and under
+// AddressSanitizer/UndefinedBehaviorSanitizer:
+//   g++ -O0 -std=c++11 -pthread CheckE3C.cxx -o CheckE3C_O0 && ./CheckE3C_O0
+//   g++ -O1 -g -std=c++11 -pthread -fsanitize=address,undefined CheckE3C.cxx -o CheckE3C_asan && ./CheckE3C_asan
+// and for the thread pool under ThreadSanitizer:
+//   g++ -O1 -g -std=c++11 -pthread -fsanitize=thread CheckE3C.cxx -o CheckE3C_tsan && ./CheckE3C_tsan
+// Exits with 1 if a check fails.
+//
+// engines:  the sorted-pair engine against the triplet loop, all four modes,
+//           every family, kind and variant (same sums up to the rounding of
+//           the different addition order)
+// threads:  the thread pool (SetE3CThreads) against the serial loop for 2, 4
+//           and 7 threads, bitwise
+// split:    large calls cut into tiles (SetE3CSplitThreshold), bitwise the
+//           same for any number of threads
+// serial:   the same split calls against the serial loop, equal up to
+//           rounding
+// release:  a bank after Release of every kind (end of FinishTaskOutput)
+//           holds no cells and keeps its entries
+
+#include "AliAnalysisTaskJetsEECpbpbE3Ccode.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+//small deterministic generator, the same sequence on every platform
+struct Random
+{
+    unsigned int state = 1;
+    double Uniform()
+    {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) / 16777216.;
+    }
+};
+
+void Book(E3CHistBank &bank)
+{
+    static const double jetpt[] = {10, 20, 40, 80, 160};
+    static const double rl[] = {0.001, 0.01, 0.05, 0.1, 0.4};
+    static const double weight[] = {1e-6, 1e-4, 1e-2, 1};
+    for (int c = 0; c < kE3CNCategories; c++) {
+        bank.SetAxes(kE3CResponse, c, 4, jetpt, 4, jetpt, 4, rl);
+        bank.SetAxes(kE3CMoments, c, 4, jetpt, 4, rl);
+        bank.SetAxes(kE3CWeightAxis, c, 4, jetpt, 4, rl, 3, weight);
+        for (int k = 0; k < kE3CNKinds; k++)
+            for (int v = 0; v < kE3CNVariants; v++) bank.Book(k, c, v);
+    }
+    bank.Allocate();
+}
+
+//List of n particles in a 0.8 x 0.8 window; code 1 stands for a jet list of
+//mixed background (0) and signal (1) particles, otherwise the cone code
+void Fill(E3CParticleBlock &list, int n, int code, Random &random)
+{
+    list.Clear();
+    for (int i = 0; i < n; i++) {
+        const double pt = 1 + 9 * random.Uniform();
+        const double eta = 0.8 * (random.Uniform() - 0.5);
+        const double phi = 0.8 * (random.Uniform() - 0.5);
+        list.Add(pt, eta, phi, code == 1 ? (random.Uniform() < 0.3 ? 1 : 0) : code);
+    }
+}
+
+//Everything a bank exports: contents, Sumw2, orderings, statistics, entries
+std::vector<double> Contents(E3CHistBank &bank)
+{
+    bank.Sync();
+    std::vector<double> all;
+    for (int k = 0; k < kE3CNKinds; k++) {
+        all.insert(all.end(), bank.content[k].begin(), bank.content[k].end());
+        all.insert(all.end(), bank.sumw2[k].begin(), bank.sumw2[k].end());
+    }
+    all.insert(all.end(), bank.counts.begin(), bank.counts.end());
+    all.insert(all.end(), bank.stats.begin(), bank.stats.end());
+    all.insert(all.end(), bank.entries.begin(), bank.entries.end());
+    return all;
+}
+
+//Largest |a - b| / max(|a|, |b|) over the cells, 1 if the sizes differ
+double MaxRelDifference(const std::vector<double> &a, const std::vector<double> &b)
+{
+    if (a.size() != b.size()) return 1;
+    double worst = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        const double scale = std::max(std::fabs(a[i]), std::fabs(b[i]));
+        if (scale > 0) worst = std::max(worst, std::fabs(a[i] - b[i]) / scale);
+    }
+    return worst;
+}
+
+bool Identical(const std::vector<double> &a, const std::vector<double> &b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+bool Report(const char *check, bool ok, double deviation)
+{
+    std::printf("%-8s %s (max relative deviation %g)\n", check, ok ? "ok" : "FAILED", deviation);
+    return ok;
+}
+
+//The same calls, all modes and list codes, for every engine, thread count and
+//split threshold; nThreads = 1 computes them in place
+std::vector<double> Run(E3CEngine engine, int nThreads, int splitThreshold, int events, int maxMultiplicity)
+{
+    //codes of the three lists, so that every category of every mode is reached
+    static const int codes[][3] = {{1, -2, -3}, {-2, 1, -4}, {-2, -3, -4}, {-3, -2, -2}, {1, -3, -3}};
+    const int nCodes = sizeof(codes) / sizeof(codes[0]);
+
+    E3CHistBank bank;
+    Book(bank);
+    E3CWorkspace work;
+    E3CParallel parallel;
+    parallel.nThreads = nThreads;
+    parallel.splitThreshold = splitThreshold;
+    if (parallel.Enabled()) parallel.Start();
+
+    Random random;
+    E3CParticleBlock a, b, c;
+    for (int event = 0; event < events; event++) {
+        //every list code with every (matched, cfactor)
+        for (int jet = 0; jet < 4 * nCodes; jet++) {
+            const int *code = codes[jet % nCodes];
+            const int n = 3 + (event * 7 + jet * 13) % maxMultiplicity;
+            Fill(a, n, code[0], random);
+            Fill(b, n / 2 + 2, code[1], random);
+            Fill(c, n / 3 + 2, code[2], random);
+            const double jetpt = 15 + 130 * random.Uniform();
+            const double pt = 15 + 130 * random.Uniform();
+            const bool matched = jet / nCodes % 2, cfactor = jet / nCodes / 2;
+            for (int m = 0; m < kE3CNModes; m++) {
+                if (parallel.Enabled())
+                    parallel.Submit((E3CMode)m, engine, matched, cfactor, a, b, c, jetpt, pt);
+                else
+                    E3CCompute((E3CMode)m, engine, matched, cfactor, a, b, c, jetpt, pt, work, bank);
+            }
+        }
+        if (parallel.Enabled()) parallel.Run(bank, [](const E3CParallel::Job &) {});
+    }
+    return Contents(bank);
+}
+
+//Cells left in a bank after releasing every kind, and whether the entries survived
+bool Released(E3CHistBank &bank, const std::vector<double> &entries)
+{
+    size_t cells = 0;
+    for (int k = 0; k < kE3CNKinds; k++) {
+        bank.Release(k);
+        cells += bank.content[k].capacity() + bank.sumw2[k].capacity() + bank.contentF[k].capacity() + bank.sumw2F[k].capacity();
+    }
+    cells += bank.counts.capacity() + bank.countsF.capacity();
+    return cells == 0 && bank.entries == entries;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+
+    const std::vector<double> triplet = Run(kE3CEngineTriplet, 1, INT_MAX, 40, 40);
+    const double engines = MaxRelDifference(triplet, Run(kE3CEngineSortedPairs, 1, INT_MAX, 40, 40));
+    ok &= Report("engines", engines < 1e-12, engines);
+
+    for (int nThreads : {2, 4, 7}) {
+        const std::vector<double> threads = Run(kE3CEngineTriplet, nThreads, INT_MAX, 40, 40);
+        char check[32];
+        std::snprintf(check, sizeof(check), "threads%d", nThreads);
+        ok &= Report(check, Identical(triplet, threads), MaxRelDifference(triplet, threads));
+    }
+
+    const std::vector<double> serial = Run(kE3CEngineTriplet, 1, INT_MAX, 3, 120);
+    const std::vector<double> split = Run(kE3CEngineTriplet, 2, 60, 3, 120);
+    for (int nThreads : {4, 7}) {
+        const std::vector<double> threads = Run(kE3CEngineTriplet, nThreads, 60, 3, 120);
+        ok &= Report("split", Identical(split, threads), MaxRelDifference(split, threads));
+    }
+    const double splitSerial = MaxRelDifference(serial, split);
+    ok &= Report("serial", splitSerial < 1e-12, splitSerial);
+
+    E3CHistBank bank;
+    Book(bank);
+    bank.entries.assign(bank.entries.size(), 1.);
+    const std::vector<double> entries = bank.entries;
+    ok &= Report("release", Released(bank, entries), 0);
+
+    return ok ? 0 : 1;
+}
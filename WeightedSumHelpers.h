@@ -0,0 +1,95 @@
+#ifndef WEIGHTEDSUMHELPERS_H
+#define WEIGHTEDSUMHELPERS_H
+
+//Shared by the macros that read the summed weight per (jet pT, R_L): from the exact moments hw_*
+//written by the E3C bank of the task or, for the other outputs (EEC, unfolded Opt_Un_*) and the
+//per-weight-bin c-factors, from the weight axis of a TH3. FillWeightedSum stays in each macro
+//(some scale by the bin width)
+
+#include "TFile.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AliAnalysisTaskJetsEECpbpbE3Ccode.h"
+
+void FillWeightedSum(TH2* h2, TH1* h1);
+
+//Moments name (hw_<cat>, hwJet_deltaR_MJ*_e3c) of an E3C weight-axis name (h3_<cat>,
+//h3Jet_deltaR_MJ*_e3c, any variant suffix); empty for names the E3C bank does not write
+std::string E3CMomentsName(const std::string& name) {
+    for (int c = 0; c < kE3CNCategories; c++)
+        for (int v = 0; v < kE3CNVariants; v++)
+            if (name == E3CHistName(kE3CWeightAxis, c, v)) return E3CHistName(kE3CMoments, c, v);
+    return "";
+}
+
+//Missing input: E3C weight-axis names are booked by the task only on request
+void ReportMissingHist(TFile* file, const std::string& name) {
+    std::cerr << "Error: " << name << " not found in " << file->GetName();
+    if (!E3CMomentsName(name).empty())
+        std::cerr << "; the E3C weight-axis histograms are opt-in, run the task with "
+                  << "SetE3CFamilies(variants, categories, kE3CKindsAll)";
+    std::cerr << std::endl;
+}
+
+//Inputs of one subtraction, all read the same way so that they can be added: the hw_* moments
+//(x jet pT, y R_L, content the sum of the weights, Sumw2 the sum of their squares) when the file has
+//one for every name, the TH3 of every name otherwise. Empty, after naming the missing input, if
+//neither covers all of them
+std::vector<TH1*> GetWeightedSumSources(TFile* file, const std::vector<std::string>& names) {
+    std::vector<TH1*> hists;
+    for (const std::string& name : names) {
+        const std::string moments = E3CMomentsName(name);
+        TH2* hw = moments.empty() ? nullptr : dynamic_cast<TH2*>(file->Get(moments.c_str()));
+        if (!hw) break;
+        hists.push_back(hw);
+    }
+    if (hists.size() == names.size()) return hists;
+
+    hists.clear();
+    for (const std::string& name : names) {
+        TH3* h3 = dynamic_cast<TH3*>(file->Get(name.c_str()));
+        if (!h3) {
+            ReportMissingHist(file, name);
+            return std::vector<TH1*>();
+        }
+        hists.push_back(h3);
+    }
+    return hists;
+}
+
+//Single input, nullptr if missing
+TH1* GetWeightedSumSource(TFile* file, const std::string& name) {
+    const std::vector<TH1*> hists = GetWeightedSumSources(file, std::vector<std::string>(1, name));
+    return hists.empty() ? nullptr : hists[0];
+}
+
+//R_L distribution summed over the jet pT bins [binLo, binHi]: projected directly from a moments TH2,
+//rebuilt from the bin centres of the weight axis (FillWeightedSum) for a TH3
+TH1D* WeightedSumRL(TH1* h, const char* name, int binLo, int binHi) {
+    if (h->GetDimension() == 3) {
+        TH3* h3 = (TH3*)h;
+        h3->GetXaxis()->SetRange(binLo, binHi);
+        TH2D* h2 = (TH2D*)h3->Project3D("zy");
+        TH1D* h1 = (TH1D*)h2->ProjectionX(name);
+        h1->Reset();
+        FillWeightedSum(h2, h1);
+        return h1;
+    }
+    return ((TH2*)h)->ProjectionY(name, binLo, binHi, "e");
+}
+
+//(jet pT, R_L, weight) histogram for the per-weight-bin c-factors; a missing one clears ok
+TH3D* GetWeightAxisHist(TFile* file, const char* name, bool& ok) {
+    TH3D* h = dynamic_cast<TH3D*>(file->Get(name));
+    if (!h) {
+        ReportMissingHist(file, name);
+        ok = false;
+    }
+    return h;
+}
+
+#endif